@@ -0,0 +1,191 @@
+// Binder事件(tracefs) 原始页解析的回放与性能测试, 只依赖libc, 普通Linux即可运行, 不需要Android设备
+//
+// fixture/header_page 及 fixture/binder_transaction_format 为内核 tracefs 中对应文件的内容
+// fixture/binder_trace_page.bin 为按该格式合成的 trace_pipe_raw 原始页, 含时间扩展、填充、其他事件及长事件
+//
+// 编译: g++ -std=c++20 -O2 -I../include binderTraceBench.cpp -o binderTraceBench
+// 回放: ./binderTraceBench fixture            校验原始页与生成结果一致, 且解析结果符合预期
+// 性能: ./binderTraceBench fixture 100000     重复解析指定次数并输出吞吐
+// 生成: ./binderTraceBench fixture -g         格式变更后重新生成原始页
+
+#include <chrono>
+#include "binderTrace.hpp"
+
+using std::vector;
+
+struct summaryStruct {
+    int eventCnt = 0;
+    int replyCnt = 0;
+    int onewayCnt = 0;
+    int64_t pidSum = 0; // 校验字段读取位置
+};
+
+static bool readText(const char* dir, const char* name, char* buff, const size_t size) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    FILE* fp = fopen(path, "rb");
+    if (fp == nullptr) return false;
+    const size_t len = fread(buff, 1, size - 1, fp);
+    fclose(fp);
+    buff[len] = 0;
+    return len > 0;
+}
+
+template <typename T>
+static void writeAt(uint8_t* ptr, const T value) {
+    memcpy(ptr, &value, sizeof(T));
+}
+
+static void addSummary(summaryStruct& summary, const BinderTrace::binderTransaction& transaction) {
+    summary.eventCnt++;
+    summary.replyCnt += transaction.isReply;
+    summary.onewayCnt += transaction.isOneway;
+    summary.pidSum += transaction.fromPid + transaction.toProc + transaction.toThread;
+}
+
+// 按格式合成一页原始数据, 同时得到预期的解析结果
+static vector<uint8_t> makePage(const BinderTrace::formatStruct& fmt, summaryStruct& expect) {
+    constexpr uint32_t TYPE_PADDING = 29, TYPE_TIME_EXTEND = 30;
+    constexpr uint16_t OTHER_EVENT_SIZE = 12;
+
+    vector<uint8_t> page(fmt.pageSize, 0);
+    uint8_t* const data = page.data() + fmt.dataOffset;
+    const size_t dataSize = fmt.pageSize - fmt.dataOffset;
+    const size_t payloadLen = (static_cast<size_t>(fmt.flagsOffset) + 4 + 3) & ~size_t(3);
+
+    writeAt<uint64_t>(page.data(), 123456789ULL); // timestamp
+
+    size_t pos = 0;
+    for (int i = 0; ; i++) {
+        const bool isLong = i % 16 == 15;
+        if (pos + 8 + payloadLen + 8 > dataSize) break;
+
+        if (i % 10 == 9) { // 时间扩展
+            writeAt<uint32_t>(data + pos, TYPE_TIME_EXTEND | (7u << 5));
+            writeAt<uint32_t>(data + pos + 4, 1);
+            pos += 8;
+        }
+        if (i % 23 == 22) { // 被丢弃的事件留下的填充
+            writeAt<uint32_t>(data + pos, TYPE_PADDING | (1u << 5));
+            writeAt<uint32_t>(data + pos + 4, 4 + 8);
+            pos += 4 + 4 + 8;
+        }
+        if (i % 7 == 6) { // 其他事件 如 binder_transaction_received
+            writeAt<uint32_t>(data + pos, (OTHER_EVENT_SIZE / 4) | (3u << 5));
+            writeAt<uint16_t>(data + pos + 4, fmt.eventId + 1);
+            writeAt<int32_t>(data + pos + 8, 4000 + i);
+            pos += 4 + OTHER_EVENT_SIZE;
+        }
+
+        uint8_t* payload;
+        if (isLong) { // type_len 为0, 长度在第二个字
+            writeAt<uint32_t>(data + pos, 0 | (5u << 5));
+            writeAt<uint32_t>(data + pos + 4, static_cast<uint32_t>(4 + payloadLen));
+            payload = data + pos + 8;
+            pos += 8 + payloadLen;
+        }
+        else {
+            writeAt<uint32_t>(data + pos, static_cast<uint32_t>(payloadLen / 4) | (5u << 5));
+            payload = data + pos + 4;
+            pos += 4 + payloadLen;
+        }
+
+        const BinderTrace::binderTransaction transaction{
+            .fromPid = 1000 + i,
+            .toProc = 2000 + i % 50,
+            .toThread = i % 3 ? 0 : 3000 + i,
+            .isReply = i % 4 == 3,
+            .isOneway = !(i % 4 == 3) && i % 5 == 0,
+        };
+        writeAt<uint16_t>(payload, fmt.eventId);
+        writeAt<int32_t>(payload + 4, transaction.fromPid);
+        writeAt<int32_t>(payload + fmt.toProcOffset, transaction.toProc);
+        writeAt<int32_t>(payload + fmt.toThreadOffset, transaction.toThread);
+        writeAt<int32_t>(payload + fmt.replyOffset, transaction.isReply ? 1 : 0);
+        writeAt<uint32_t>(payload + fmt.flagsOffset, transaction.isOneway ? 0x11u : 0x10u);
+        addSummary(expect, transaction);
+    }
+
+    // 页尾空事件
+    writeAt<uint32_t>(data + pos, TYPE_PADDING);
+    if (fmt.commitSize == 8)
+        writeAt<uint64_t>(page.data() + fmt.commitOffset, pos);
+    else
+        writeAt<uint32_t>(page.data() + fmt.commitOffset, static_cast<uint32_t>(pos));
+    return page;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "用法: %s <fixture目录> [重复次数 | -g]\n", argv[0]);
+        return 1;
+    }
+    const char* dir = argv[1];
+
+    char headerPage[1024], eventFormat[4096];
+    if (!readText(dir, "header_page", headerPage, sizeof(headerPage)) ||
+        !readText(dir, "binder_transaction_format", eventFormat, sizeof(eventFormat))) {
+        fprintf(stderr, "读取 %s 中的格式文件失败\n", dir);
+        return 1;
+    }
+
+    BinderTrace::formatStruct fmt;
+    if (!BinderTrace::parseFormat(headerPage, eventFormat, fmt)) {
+        fprintf(stderr, "解析 binder_transaction 事件格式失败\n");
+        return 1;
+    }
+
+    summaryStruct expect;
+    const auto expectPage = makePage(fmt, expect);
+
+    char pagePath[256];
+    snprintf(pagePath, sizeof(pagePath), "%s/binder_trace_page.bin", dir);
+
+    if (argc > 2 && !strcmp(argv[2], "-g")) {
+        FILE* fp = fopen(pagePath, "wb");
+        if (fp == nullptr || fwrite(expectPage.data(), 1, expectPage.size(), fp) != expectPage.size()) {
+            fprintf(stderr, "写入 %s 失败\n", pagePath);
+            return 1;
+        }
+        fclose(fp);
+        printf("已生成 %s: %d 事件\n", pagePath, expect.eventCnt);
+        return 0;
+    }
+
+    vector<uint8_t> page(fmt.pageSize);
+    FILE* fp = fopen(pagePath, "rb");
+    if (fp == nullptr) {
+        fprintf(stderr, "打开 %s 失败\n", pagePath);
+        return 1;
+    }
+    const size_t pageLen = fread(page.data(), 1, page.size(), fp);
+    fclose(fp);
+    if (pageLen != expectPage.size() || memcmp(page.data(), expectPage.data(), pageLen)) {
+        fprintf(stderr, "原始页与当前格式生成的不一致, 格式变更后需用 -g 重新生成\n");
+        return 1;
+    }
+
+    summaryStruct summary;
+    BinderTrace::parsePage(page.data(), pageLen, fmt, [&summary](const auto& transaction) {
+        addSummary(summary, transaction);
+    });
+    printf("回放: 事件%d 回复%d 单向%d\n", summary.eventCnt, summary.replyCnt, summary.onewayCnt);
+    if (summary.eventCnt != expect.eventCnt || summary.replyCnt != expect.replyCnt ||
+        summary.onewayCnt != expect.onewayCnt || summary.pidSum != expect.pidSum) {
+        fprintf(stderr, "解析结果不符合预期: 事件%d 回复%d 单向%d\n", expect.eventCnt, expect.replyCnt, expect.onewayCnt);
+        return 1;
+    }
+
+    const int loopCnt = argc > 2 ? atoi(argv[2]) : 0;
+    if (loopCnt <= 0) return 0;
+
+    int64_t eventCnt = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < loopCnt; i++)
+        eventCnt += BinderTrace::parsePage(page.data(), pageLen, fmt, [](const auto&) {});
+    const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    printf("性能: %d页 %lld事件 耗时%.3fs, %.0f页/s, %.1fns/事件\n", loopCnt, static_cast<long long>(eventCnt), sec,
+        loopCnt / sec, sec * 1e9 / static_cast<double>(eventCnt));
+    return 0;
+}
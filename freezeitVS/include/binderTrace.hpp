@@ -0,0 +1,274 @@
+#pragma once
+
+// 通过 tracefs 的 binder/binder_transaction 事件获取Binder通信, 不依赖ReKernel
+// 只依赖libc, 可单独包含本文件, freezeitVS/bench/binderTraceBench.cpp 用合成的原始页回放测试/性能对比
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+class BinderTrace {
+public:
+    struct binderTransaction {
+        int fromPid;    // 发起线程 common_pid
+        int toProc;     // 目标进程
+        int toThread;   // 目标线程 0:未指定
+        bool isReply;
+        bool isOneway;
+    };
+
+    // 原始页与事件的字段偏移, 来自 events/header_page 及 binder_transaction/format
+    struct formatStruct {
+        uint32_t pageSize = 4096;
+        uint16_t commitOffset = 8;
+        uint16_t commitSize = 8;
+        uint16_t dataOffset = 16;
+        uint16_t eventId = 0;
+        uint16_t toProcOffset = 0;
+        uint16_t toThreadOffset = 0;
+        uint16_t replyOffset = 0;
+        uint16_t flagsOffset = 0;
+    };
+
+    formatStruct fmt;
+
+private:
+    static constexpr uint32_t TF_ONE_WAY = 0x01;
+
+    // ring_buffer 事件头 type_len 取值
+    static constexpr uint32_t RINGBUF_TYPE_PADDING = 29;
+    static constexpr uint32_t RINGBUF_TYPE_TIME_EXTEND = 30;
+    static constexpr uint32_t RINGBUF_TYPE_TIME_STAMP = 31;
+
+    char tracePath[128] = {};
+    char instancePath[192] = {};
+    std::vector<int> cpuFds;
+    std::vector<uint8_t> pageBuff;
+
+    static bool readFile(const char* path, char* buff, const size_t maxLen) {
+        const int fd = open(path, O_RDONLY);
+        if (fd < 0) return false;
+        const ssize_t len = read(fd, buff, maxLen - 1);
+        close(fd);
+        if (len <= 0) return false;
+        buff[len] = 0;
+        return true;
+    }
+
+    static bool writeFile(const char* path, const char* value) {
+        const int fd = open(path, O_WRONLY | O_TRUNC);
+        if (fd < 0) return false;
+        const bool res = write(fd, value, strlen(value)) > 0;
+        close(fd);
+        return res;
+    }
+
+    // 在 "field:int to_proc;\toffset:16;\tsize:4;" 中查找字段的 offset/size
+    static bool getFieldOffset(const char* format, const char* name, uint16_t& offset, uint16_t* size = nullptr) {
+        const size_t nameLen = strlen(name);
+        for (const char* ptr = strstr(format, name); ptr; ptr = strstr(ptr + 1, name)) {
+            const char endChar = ptr[nameLen];
+            if ((endChar != ';' && endChar != '[') || (ptr[-1] != ' ' && ptr[-1] != '\t')) continue;
+
+            const char* offsetPtr = strstr(ptr, "offset:");
+            if (offsetPtr == nullptr) return false;
+            offset = static_cast<uint16_t>(atoi(offsetPtr + 7));
+            if (size) {
+                const char* sizePtr = strstr(offsetPtr, "size:");
+                if (sizePtr == nullptr) return false;
+                *size = static_cast<uint16_t>(atoi(sizePtr + 5));
+            }
+            return true;
+        }
+        return false;
+    }
+
+    bool loadFormat() {
+        char path[256], headerPage[1024], eventFormat[4096];
+
+        snprintf(path, sizeof(path), "%s/events/header_page", tracePath);
+        if (!readFile(path, headerPage, sizeof(headerPage))) headerPage[0] = 0;
+
+        snprintf(path, sizeof(path), "%s/events/binder/binder_transaction/format", tracePath);
+        if (!readFile(path, eventFormat, sizeof(eventFormat))) return false;
+
+        return parseFormat(headerPage, eventFormat, fmt);
+    }
+
+    template <typename T>
+    static T readAt(const uint8_t* ptr) {
+        T value;
+        memcpy(&value, ptr, sizeof(T));
+        return value;
+    }
+
+public:
+    // 由 events/header_page 及 binder_transaction/format 的内容得到字段偏移, header_page 为空则使用默认值
+    static bool parseFormat(const char* headerPage, const char* eventFormat, formatStruct& fmt) {
+        if (headerPage[0]) {
+            uint16_t unused;
+            getFieldOffset(headerPage, "commit", fmt.commitOffset, &fmt.commitSize);
+            getFieldOffset(headerPage, "data", fmt.dataOffset, &unused);
+        }
+
+        const char* idPtr = strstr(eventFormat, "ID:");
+        if (idPtr == nullptr) return false;
+        fmt.eventId = static_cast<uint16_t>(atoi(idPtr + 3));
+
+        return getFieldOffset(eventFormat, "to_proc", fmt.toProcOffset) &&
+            getFieldOffset(eventFormat, "to_thread", fmt.toThreadOffset) &&
+            getFieldOffset(eventFormat, "reply", fmt.replyOffset) &&
+            getFieldOffset(eventFormat, "flags", fmt.flagsOffset);
+    }
+
+    BinderTrace() = default;
+    BinderTrace(const BinderTrace&) = delete;
+    BinderTrace& operator=(const BinderTrace&) = delete;
+
+    ~BinderTrace() {
+        for (const int fd : cpuFds) close(fd);
+        if (instancePath[0]) {
+            char path[256];
+            snprintf(path, sizeof(path), "%s/events/binder/binder_transaction/enable", instancePath);
+            writeFile(path, "0");
+            rmdir(instancePath);
+        }
+    }
+
+    // 成功返回 nullptr, 否则返回失败原因
+    const char* init(const char* instanceName) {
+        if (!access("/sys/kernel/tracing/events/binder", F_OK))
+            strcpy(tracePath, "/sys/kernel/tracing");
+        else if (!access("/sys/kernel/debug/tracing/events/binder", F_OK))
+            strcpy(tracePath, "/sys/kernel/debug/tracing");
+        else
+            return "未找到 tracefs 或内核不支持 binder 事件";
+
+        if (!loadFormat())
+            return "解析 binder_transaction 事件格式失败";
+
+        // 使用独立的实例, 不影响系统及其他工具的 trace
+        snprintf(instancePath, sizeof(instancePath), "%s/instances/%s", tracePath, instanceName);
+        if (mkdir(instancePath, 0700) && access(instancePath, F_OK)) {
+            instancePath[0] = 0;
+            return "创建 tracefs 实例失败";
+        }
+
+        char path[256];
+        snprintf(path, sizeof(path), "%s/buffer_size_kb", instancePath);
+        writeFile(path, "256");
+        snprintf(path, sizeof(path), "%s/buffer_percent", instancePath);
+        writeFile(path, "0"); // 有数据就唤醒 poll, 不等待缓冲区填满
+        snprintf(path, sizeof(path), "%s/events/binder/binder_transaction/enable", instancePath);
+        if (!writeFile(path, "1"))
+            return "开启 binder_transaction 事件失败";
+        snprintf(path, sizeof(path), "%s/tracing_on", instancePath);
+        writeFile(path, "1");
+
+        const long cpuCnt = sysconf(_SC_NPROCESSORS_CONF);
+        for (long cpu = 0; cpu < cpuCnt; cpu++) {
+            snprintf(path, sizeof(path), "%s/per_cpu/cpu%ld/trace_pipe_raw", instancePath, cpu);
+            const int fd = open(path, O_RDONLY | O_NONBLOCK);
+            if (fd >= 0) cpuFds.emplace_back(fd);
+        }
+        if (cpuFds.empty())
+            return "打开 trace_pipe_raw 失败";
+
+        fmt.pageSize = static_cast<uint32_t>(getpagesize());
+        pageBuff.resize(fmt.pageSize);
+        return nullptr;
+    }
+
+    // 解析一页原始数据, 返回 binder_transaction 事件数
+    template <typename Callback>
+    static int parsePage(const uint8_t* page, const size_t len, const formatStruct& fmt, Callback&& callback) {
+        if (len <= fmt.dataOffset) return 0;
+
+        uint64_t commit = fmt.commitSize == 8 ? readAt<uint64_t>(page + fmt.commitOffset) :
+            readAt<uint32_t>(page + fmt.commitOffset);
+        commit &= 0x0fffffff; // 高位为 MISSED_EVENTS 等标志
+
+        const uint8_t* const data = page + fmt.dataOffset;
+        const size_t dataLen = commit < len - fmt.dataOffset ? commit : len - fmt.dataOffset;
+
+        int eventCnt = 0;
+        size_t pos = 0;
+        while (pos + 4 <= dataLen) {
+            const uint32_t header = readAt<uint32_t>(data + pos);
+            const uint32_t typeLen = header & 0x1f;
+
+            size_t eventLen, payloadPos, payloadLen;
+            if (typeLen == RINGBUF_TYPE_PADDING) {
+                if ((header >> 5) == 0 || pos + 8 > dataLen) break; // 页尾空事件
+                pos += 4 + readAt<uint32_t>(data + pos + 4);
+                continue;
+            }
+            else if (typeLen == RINGBUF_TYPE_TIME_EXTEND || typeLen == RINGBUF_TYPE_TIME_STAMP) {
+                pos += 8;
+                continue;
+            }
+            else if (typeLen == 0) {
+                if (pos + 8 > dataLen) break;
+                const uint32_t arrayLen = readAt<uint32_t>(data + pos + 4);
+                if (arrayLen < 4) break;
+                eventLen = 4 + arrayLen;
+                payloadPos = pos + 8;
+                payloadLen = arrayLen - 4;
+            }
+            else {
+                eventLen = 4 + typeLen * 4;
+                payloadPos = pos + 4;
+                payloadLen = typeLen * 4;
+            }
+
+            if (pos + eventLen > dataLen) break;
+            pos += eventLen;
+
+            const uint8_t* const payload = data + payloadPos;
+            if (payloadLen < 8 || readAt<uint16_t>(payload) != fmt.eventId) continue;
+            if (payloadLen < static_cast<size_t>(fmt.flagsOffset) + 4) continue;
+
+            const binderTransaction transaction{
+                .fromPid = readAt<int32_t>(payload + 4),
+                .toProc = readAt<int32_t>(payload + fmt.toProcOffset),
+                .toThread = readAt<int32_t>(payload + fmt.toThreadOffset),
+                .isReply = readAt<int32_t>(payload + fmt.replyOffset) != 0,
+                .isOneway = (readAt<uint32_t>(payload + fmt.flagsOffset) & TF_ONE_WAY) != 0,
+            };
+            callback(transaction);
+            eventCnt++;
+        }
+        return eventCnt;
+    }
+
+    // 阻塞读取所有CPU的事件, 出错才返回
+    template <typename Callback>
+    void readLoop(Callback&& callback) {
+        std::vector<pollfd> pollFds;
+        for (const int fd : cpuFds)
+            pollFds.push_back({ fd, POLLIN, 0 });
+
+        while (true) {
+            if (poll(pollFds.data(), pollFds.size(), -1) < 0) {
+                if (errno == EINTR) continue;
+                return;
+            }
+
+            for (auto& pfd : pollFds) {
+                if (!(pfd.revents & POLLIN)) continue;
+
+                ssize_t len;
+                while ((len = read(pfd.fd, pageBuff.data(), pageBuff.size())) > 0) {
+                    parsePage(pageBuff.data(), len, fmt, callback);
+                }
+            }
+        }
+    }
+};
@@ -105,11 +105,9 @@ private:
         public static final int DISPLAY_STATE_ON_SUSPEND = 6; //非Doze, 类似4
         */
         do {
-            char res[128]; // MAX LEN: 96
-            int mScreenState;
-            if (__system_property_get("debug.tracing.screen_state", res) < 1)
+            int mScreenState = systemTools.screenState;
+            if (mScreenState < 0)
                 mScreenState = getScreenByLocalSocket();
-            else mScreenState = res[0] - '0';
 /*
             int mScreenState = getScreenByLocalSocket();
             if (mScreenState < 0)
@@ -139,20 +137,20 @@ private:
                 break;
             }
 
-            // "Unknown", "Charging", "Discharging", "Not charging", "Full"
-            // https://cs.android.com/android/kernel/superproject/+/common-android-mainline-kleaf:common/drivers/power/supply/power_supply_sysfs.c;l=75
-            Utils::readString("/sys/class/power_supply/battery/status", res, sizeof(res));
-            if (!strncmp(res, "Charging", 4) || !strncmp(res, "Full", 4)) {
+            if (systemTools.chargeState < 0) // 未能监听 uevent
+                systemTools.updateChargeState();
+
+            if (systemTools.chargeState == 1) {
                 freezeit.debug("息屏, 充电中");
                 break;
             }
 
-            if (!strncmp(res, "Discharging", 4) || !strncmp(res, "Not charging", 4)) {
+            if (systemTools.chargeState == 0) {
                 freezeit.debug("息屏, 未充电");
                 return false;
             }
 
-            freezeit.debugFmt("息屏, 电池状态未知 [%s]", res);
+            freezeit.debug("息屏, 电池状态未知");
 
         } while (false);
 
@@ -164,6 +162,23 @@ public:
     Doze& operator=(Doze&&) = delete;
 
     bool isScreenOffStandby = false;
+    time_t standbyStartTime = 0;
+    STANDBY_TIER standbyTier = STANDBY_TIER::FREEZE;
+    int wakeupAvoidedCnt = 0; // 本次待机因无闹钟/任务而跳过的定时解冻
+    int wakeupWindowCnt = 0;  // 本次待机的定时解冻批次数
+
+    // 息屏时长达到下一阶段则推进, 返回是否有新阶段 call once per 1sec
+    bool updateStandbyTier() {
+        if (!isScreenOffStandby || !settings.isStandbyTierEnable() || standbyTier == STANDBY_TIER::HOLD_WAKEUP)
+            return false;
+
+        const auto nextTier = static_cast<STANDBY_TIER>(static_cast<int>(standbyTier) + 1);
+        if (time(nullptr) - standbyStartTime < settings.getStandbyTierTimeout(nextTier))
+            return false;
+
+        standbyTier = nextTier;
+        return true;
+    }
 
     Doze(Freezeit& freezeit, Settings& settings, ManagedApp& managedApp, SystemTools& systemTools) :
         freezeit(freezeit), managedApp(managedApp), systemTools(systemTools), settings(settings) {
@@ -180,6 +195,7 @@ public:
         }
 
         isScreenOffStandby = false;
+        standbyTier = STANDBY_TIER::FREEZE;
 
         if (settings.enableDoze) {
             system("dumpsys deviceidle unforce");
@@ -212,6 +228,11 @@ public:
                 }
                 if (deltaTime) tmp.appendFmt("%d秒", deltaTime);
                 tmp.appendFmt(" 唤醒率 %d.%d %%", activeRate / 10, activeRate % 10);
+                if (wakeupAvoidedCnt)
+                    tmp.appendFmt(" 免定时解冻 %d次", wakeupAvoidedCnt);
+                if (wakeupWindowCnt)
+                    tmp.appendFmt(" 定时解冻窗口 %d次(%.1f次/时)", wakeupWindowCnt,
+                        wakeupWindowCnt * 3600.0 / (time(nullptr) - enterDozeTimeStamp));
                 freezeit.log(tmp.c_str(), tmp.length);
 
                 struct st {
@@ -276,6 +297,9 @@ public:
         }
 
         isScreenOffStandby = true;
+        standbyStartTime = nowTimeStamp;
+        wakeupAvoidedCnt = wakeupWindowCnt = 0;
+        standbyTier = STANDBY_TIER::FREEZE;
 
         if (settings.enableDoze) {
             freezeit.debug("开始准备深度Doze");
@@ -309,7 +333,7 @@ public:
             int uid;
             long long userTime, systemTime; // us 微秒
             sscanf(line.c_str(), "%d: %lld %lld", &uid, &userTime, &systemTime);
-            if (managedApp.isBlackList(uid) && (userTime >= 1000 || systemTime >= 1000)) {
+            if ((managedApp.isBlackList(uid) || managedApp.isScreenOffMode(uid)) && (userTime >= 1000 || systemTime >= 1000)) {
                 auto& appTime = uidTime[uid];
                 appTime.lastTotal = appTime.total;
                 appTime.total = static_cast<int>((systemTime + userTime) / 1000);  // ms 取毫秒
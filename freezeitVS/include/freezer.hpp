@@ -6,15 +6,28 @@
 #include "doze.hpp"
 #include "freezeit.hpp"
 #include "systemTools.hpp"
+#include "binderTrace.hpp"
 #include <linux/netlink.h>
 #include <netinet/tcp.h>
 #include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
 
 #define PACKET_SIZE      256
 #define USER_PORT        100
 #define MAX_PLOAD        125
 #define MSG_LEN          125
 
+#ifndef __NR_pidfd_open
+#define __NR_pidfd_open 434
+#endif
+#ifndef __NR_process_madvise
+#define __NR_process_madvise 440
+#endif
+#ifndef MADV_PAGEOUT
+#define MADV_PAGEOUT 21
+#endif
+
 typedef struct _user_msg_info
 {
     struct nlmsghdr hdr;
@@ -39,11 +52,193 @@ private:
     unordered_set<int> naughtyApp;                 //冻结期间存在异常解冻或唤醒进程的应用
     unordered_set<int> lastAudioApp;               //上次播放音频的应用   
     unordered_set<int> currentAudioApp;            //当前正在播放音频的应用 
+    uint32_t audioUidVersion = 0;
 
     mutex naughtyMutex;
 
+    struct partialThawStruct {
+        int uid = 0;
+        int remainSec = 0;      // 剩余解冻时间
+        int thawSec = 0;        // 累计解冻时间(含延长)
+        int cpuTimeStart = 0;   // 解冻时进程CPU时间 ms
+        int lastCpuMs = 0;      // 静默检测 上次采样的CPU时间
+        int flatCnt = 0;        // 静默检测 连续无变化次数
+    };
+    map<int, partialThawStruct> partialThawList;   // 局部临时解冻列队 只解冻Binder目标进程 { pid, info }
+    mutex partialThawMutex;
+
+    struct thawCostStruct {
+        int cpuTimeMs = 0;
+        int thawSec = 0;
+    };
+    unordered_map<int, thawCostStruct> fullThawCost;      // 整应用临时解冻的CPU开销统计 { uid, cost }
+    unordered_map<int, pair<int, time_t>> fullThawStart;  // 整应用临时解冻开始时 { uid, {cpuTimeMs, timestamp} }
+    int partialThawCnt = 0, partialThawExtendCnt = 0, partialThawSkipPidCnt = 0;
+    int partialThawCpuUsedMs = 0, partialThawCpuSavedMs = 0, partialThawEstCnt = 0; // 节省只能对有整体解冻基线的应用估算
+
+    // 静默检测: 临时/定时解冻后每100ms采样CPU时间, 连续无变化即提前冻结, 解冻时长仅作为上限
+    // /proc/pid/schedstat 只含主线程, 这里用 /proc/pid/stat 的全部线程 utime+stime
+    static constexpr int QUIESCENCE_SAMPLE_MS = 100;
+    static constexpr int QUIESCENCE_FLAT_CNT = 5;
+    static constexpr int TEMP_THAW_CEILING_SEC = 10;    // 临时解冻上限
+    struct quiescenceStruct {
+        int lastCpuMs = 0;
+        int flatCnt = 0;
+    };
+    map<int, quiescenceStruct> quiescenceList;   // 整应用解冻的静默检测 { uid, info }
+    mutex quiescenceMutex;
+    int quiescenceRefreezeCnt = 0, quiescenceSavedSec = 0;
+
+    unordered_set<int> fgServiceUids;               // 正在为前台应用提供Binder服务的应用
+    unordered_map<int, int> fgServiceDeferSec;      // 因提供服务而暂缓冻结的时长 { uid, sec }
+    time_t binderGraphTime = 0;
+    int fgServiceDeferCnt = 0;
+
+    struct binderStatStruct {
+        int sampleCnt = 0;      // 冻结期间采样次数
+        int syncRecvCnt = 0;    // 收到同步传输 (每次冻结期间只计一次)
+        int asyncRecvCnt = 0;   // 收到异步传输
+        int pendingCnt = 0;     // 采样时存在未完成传输
+    };
+    map<int, binderStatStruct> binderStats;     // 冻结期间的Binder统计 { uid, stat }
+    unordered_map<int, uint32_t> binderLastFlags;   // 上次采样的标志 { pid, flags }
+    mutex binderStatMutex;
+
+    // 冻结前的活动检测: 下载/写文件中的应用暂缓冻结
+    static constexpr uint64_t ACTIVITY_IO_BYTES_PER_SEC = 512 * 1024;
+    static constexpr uint64_t ACTIVITY_TCP_QUEUE_BYTES = 32 * 1024;
+    static constexpr int ACTIVITY_DEFER_SEC = 5;
+    static constexpr int ACTIVITY_DEFER_MAX = 600;
+    unordered_map<int, pair<uint64_t, time_t>> ioBaseline;   // { uid, {IO字节数, 时间} }
+    unordered_map<int, int> activityDeferSec;                // { uid, 已暂缓时长 }
+    int activityDeferIoCnt = 0, activityDeferNetCnt = 0;
+
+    // 待机分级: 暂停定时解冻期间累计的秒数及被推迟的应用次数
+    int wakeupHoldSec = 0, wakeupHeldCnt = 0;
+
+    // 内存压力: 在 /proc/pressure/memory 注册PSI触发器, 压力持续时逐级处理, 赶在 lmkd 查杀用户在意的应用之前
+    // 第一级 回收冻结最久的应用内存, 短时间内再次触发(或出现 full 压力)则升级为杀死价值最低的冻结应用
+    static constexpr const char* psiMemoryPath = "/proc/pressure/memory";
+    static constexpr const char* PSI_SOME_TRIGGER = "some 150000 1000000"; // 1秒内有任务累计停顿150ms
+    static constexpr const char* PSI_FULL_TRIGGER = "full 50000 1000000";  // 1秒内全部任务累计停顿50ms
+    static constexpr int PSI_RECLAIM_APP_CNT = 3;   // 每次回收的应用数
+    static constexpr int PSI_ACTION_GAP_SEC = 2;    // 两次处理的最小间隔, 等待上次处理生效
+    static constexpr int PSI_ESCALATE_SEC = 10;     // 该时间内再次触发则升级
+    static constexpr int PSI_RESET_SEC = 60;        // 该时间内未触发则回到第一级
+    unordered_map<int, time_t> psiReclaimTime;     // 因内存压力回收的时刻 { uid, timestamp }
+    int psiReclaimCnt = 0, psiReclaimKiB = 0, psiKillCnt = 0, psiKillKiB = 0;
+    static constexpr int PSI_RECHECK_MS = 5000;     // 检查开关变化的间隔
+    struct psiTaskStruct {
+        bool isPending = false, isFull = false, needTerminate = false;
+        char level[64] = {};
+    };
+    mutex psiTaskMutex;
+    psiTaskStruct psiTask; // PSI线程只负责检测, 由主循环线程处理, 避免与冻结/解冻/查杀竞争应用状态
+
+    // 息屏冻结: 进入息屏待机时批量冻结, 亮屏后经解冻队列逐个解冻
+    int screenOffFreezeCnt = 0, screenOffThawCnt = 0;
+
+    // 解冻调度: 退出息屏待机后 顶层应用立即解冻, 其余按优先级排队, 每200ms解冻 settings.getThawBatchSize() 个
+    enum class THAW_PRIORITY : int { FOREGROUND = 1, SCREENOFF = 2 };
+    static constexpr int THAW_QUEUE_DELAY_MS = 600;  // 退出待机后 这段时间只解冻顶层应用
+    vector<pair<THAW_PRIORITY, int>> thawQueue;
+    mutex thawQueueMutex;
+    int64_t thawQueueStartMs = 0;
+    bool isThawPacing = false;      // 退出待机后 直到解冻队列清空
+    int thawTopFirstCnt = 0, thawQueuedCnt = 0;
+
+    // Binder唤醒事件统计 (ReKernel / tracefs)
+    std::atomic<int> binderEventRecvCnt = 0, binderEventFilterCnt = 0, binderEventCoalesceCnt = 0;
+
+    // 解冻时间线 { 时刻(秒), 同批解冻的uid }, 相近的解冻时间在容差内对齐到同一批次, 减少唤醒次数
+    static constexpr int WAKEUP_BATCH_WINDOW_MIN = 30;
+    static constexpr int WAKEUP_BATCH_WINDOW_MAX = 600;
     uint32_t timelineIdx = 0;
-    uint32_t unfrozenTimeline[4096] = {};
+    map<uint32_t, vector<int>> unfrozenTimeline;
+    mutex timelineMutex;
+    int wakeupWindowCnt = 0, wakeupBatchAppCnt = 0;
+    const time_t wakeupWindowStartTime = time(nullptr);
+
+    // 定时解冻按 闹钟/JobScheduler 截止时间调度, 无待办则推迟到上限时间
+    static constexpr int WAKEUP_DEADLINE_REFRESH_SEC = 300;  // dumpsys 最短刷新间隔
+    static constexpr int WAKEUP_DEADLINE_TOLERANCE = 30;     // 截止时间前多少秒内直接解冻
+    static constexpr int WAKEUP_CEILING_FACTOR = 4;          // 无待办时的解冻上限 = 定时解冻间隔 x4
+    static constexpr int WAKEUP_CEILING_MAX = 3600 * 4;
+    static constexpr size_t WAKEUP_DUMP_BUF_SIZE = 512 * 1024;
+    unique_ptr<char[]> wakeupDumpBuff;
+    unordered_map<int, time_t> wakeupDeadline;   // { uid, 最近的闹钟/任务时间戳 }
+    time_t wakeupDeadlineTime = 0;
+    bool isWakeupDeadlineValid = false;
+    int wakeupAvoidedCnt = 0;
+
+    // 自适应定时解冻间隔: 解冻期间几乎没有CPU消耗则间隔翻倍, 工作量大则减半
+    static constexpr int WAKEUP_IDLE_CPU_MS = 50;
+    static constexpr int WAKEUP_BUSY_CPU_MS = 500;
+    static constexpr int WAKEUP_INTERVAL_MIN = 60 * 5;
+    static constexpr int WAKEUP_INTERVAL_MAX = 3600 * 8;
+    unordered_map<int, int> wakeupCpuStart;   // 定时解冻时的CPU时间 { uid, ms }
+
+    // 自适应冻结延迟: 按切到后台后多久回到前台的分布, 选择使"冻结后很快又被打开"的概率不超过目标的最短延迟
+    static constexpr int dwellBucketEdge[appInfoStruct::DWELL_BUCKET_CNT - 1] = { 5, 15, 30, 60, 120, 300 };
+    static constexpr int FREEZE_DELAY_MAX = 300;       // 上限, 超过该时长再回到前台不算频繁切换
+    static constexpr int FREEZE_CHURN_PERCENT = 20;    // 目标: 冻结后又在上限内回到前台的比例
+    static constexpr int DWELL_MIN_SAMPLE = 10;        // 样本不足时使用全局设置
+    static constexpr int DWELL_DECAY_TOTAL = 200;      // 样本超过该数量则整体减半, 跟随近期习惯
+    unordered_map<int, time_t> backgroundTime;        // 切到后台的时刻 { uid, timestamp }
+    bool isDwellChanged = false;
+
+    // 预解冻: 桌面/最近任务成为顶层时, 提前解冻最可能打开的几个应用, 未被选中则很快重新冻结
+    static constexpr int PRETHAW_APP_CNT = 2;
+    static constexpr int PRETHAW_WINDOW_SEC = 5;
+    struct appUsageStruct {
+        float frequency = 0;    // 打开次数 (指数衰减)
+        time_t lastUseTime = 0;
+    };
+    unordered_map<int, appUsageStruct> appUsage;
+    unordered_map<int, pair<time_t, int>> preThawList;   // { uid, {预解冻时刻, 守护进程解冻处理耗时us} }
+    mutex preThawMutex;
+    std::atomic<bool> isPreThawRequested = false;       // 解冻线程发现桌面成为顶层, 由主循环线程执行预解冻
+    bool isHomeTop = false;
+    int preThawCnt = 0, preThawHitCnt = 0;
+    int64_t preThawHitHandleUs = 0;                      // 命中时已提前完成的解冻处理耗时, 不含界面绘制
+
+    // 触摸输入: 手势结束时立即刷新前台, 触摸期间暂缓扫描/内存回收等后台工作
+    static constexpr int USER_ACTIVE_MS = 2000;          // 手势结束后仍视为活跃的时长
+    static constexpr int INPUT_IDLE_POLL_MS = 10 * 1000; // 无输入时检查一次屏幕状态
+    std::atomic<bool> isTouching = false;
+    std::atomic<int64_t> lastTouchMs = 0;
+    set<int> deferredReclaimUids;       // 触摸期间暂缓的内存回收
+
+    // 限制模式: 不冻结, 后台时压低CPU/IO配额
+    // 优先在 cgroup v2 的 uid_xxx 层设置 cpu.max, 进程仍留在原 pid_xxx 下, 不影响 freezer 层级
+    // 若 cpu 控制器挂载在 v1 (/dev/cpuctl), 则把进程移入共享的限制分组, 解除时移回原分组
+    // 小核运行: 进程移入只含最低频集群核心的 cpuset 分组 (Android 的 cpuset 均为 v1)
+    // 内存上限: uid_xxx 层的 memory.high, 超出后由内核逐步回收而非触发 lmkd 查杀; v1 则用 per-app memcg 的软上限
+    static constexpr const char* THROTTLE_CPU_MAX = "20000 100000"; // 每100ms最多运行20ms
+    static constexpr int THROTTLE_CPU_WEIGHT = 10;                  // 默认100
+    static constexpr int THROTTLE_IO_WEIGHT = 10;                   // 默认100
+    static constexpr const char* cpuctlThrottleGroup = "/frozen_throttle";
+    static constexpr const char* cpuctlLittleGroup = "/frozen_little";
+    static constexpr const char* cpusetLittleGroup = "/frozen_little";
+    static constexpr const char* LITTLE_UCLAMP_MAX = "30";          // 小核运行: 负载估计上限(%)
+    mutex restrictMutex;
+    bool isRestrictInit = false, isMemProbed = false, isCpuV2Ready = false, isIoV2Ready = false, isCpuctlReady = false;
+    bool isCpuctlLittleReady = false, isCpusetLittleReady = false, isMemV2Ready = false;
+    map<int, string> cpuctlOrigGroup, cpusetOrigGroup; // V1: { pid, 原分组 }
+    unordered_map<int, int> foregroundPeakMiB;        // 前台期间的内存峰值, 缓慢衰减 { uid, MiB }
+    unordered_map<int, int> foregroundPeakFd;         // V2: 前台期间保持打开的 memory.peak, 重置只对该fd生效 { uid, fd }
+    struct restrictStatStruct {
+        int64_t throttledBaseUs = -1; // 开始限制时 cpu.stat 的 throttled_usec
+        int64_t memStallBaseUs = -1;  // 开始限制时 memory.pressure 的 some total
+        int64_t throttledMs = 0;      // 累计被限流时长
+        int64_t memStallMs = 0;       // 累计因内存回收而停顿的时长
+    };
+    unordered_map<int, restrictStatStruct> restrictStat;
+
+    // 内存回收后端: memory.reclaim -> process_madvise -> /proc/pid/reclaim, 探测到不可用后不再尝试
+    std::atomic<bool> isMemReclaimOk = true, isReclaimSwappinessOk = true, isProcessMadviseOk = true;
+    int recycleCnt = 0;
+    int64_t recycleFreedKiB = 0, recycleAnonKiB = 0;
 
     int refreezeSecRemain = 10; //开机 一分钟时 就压一次
     int remainTimesToRefreshTopApp = 2;
@@ -77,6 +272,10 @@ private:
     static constexpr const char* cgroupV2SystemUidPidPath = "/sys/fs/cgroup/system/uid_0/cgroup.freeze";
 
 
+    static constexpr const char* binderfsTransactionsPath = "/dev/binderfs/binder_logs/transactions";
+    static constexpr const char* debugfsTransactionsPath = "/sys/kernel/debug/binder/transactions";
+
+
     static constexpr const char v2wchan[] = "do_freezer_trap";      // FreezerV2冻结状态
     static constexpr const char v1wchan[] = "__refrigerator";       // FreezerV1冻结状态
     static constexpr const char SIGSTOPwchan[] = "do_signal_stop";  // SIGSTOP冻结状态
@@ -103,10 +302,11 @@ public:
         threads.emplace_back(thread(&Freezer::bootFreeze, this));             // 开机冻结    
         threads.emplace_back(thread(&Freezer::ThawFunction, this));           // 多线程解冻    
         
-    //    threads.emplace_back(thread(&Freezer::NkBinderMagiskFunc, this));     // NkBinder
-    //    threads.emplace_back(thread(&Freezer::getAudioByLocalSocket, this));  // 监听音频播放 
     //    threads.emplace_back(thread(&Freezer::handlePendingIntent, this));    // 后台意图
         threads.emplace_back(thread(&Freezer::binderEventTriggerTask, this)); // binder事件
+        threads.emplace_back(thread(&Freezer::binderTraceTask, this));        // binder事件(tracefs)
+        threads.emplace_back(thread(&Freezer::memoryPressureThreadFunc, this)); // 内存压力
+        threads.emplace_back(thread(&Freezer::inputThreadFunc, this));        // 触摸输入
         threads.emplace_back(thread(&Freezer::cycleThreadFunc, this));                                                                                                                                
 
         checkAndMountV2();
@@ -226,10 +426,175 @@ public:
         updateAppProcess();
     }
 
-    void unFreezerTemporary(int uid, int second) {
-        curForegroundApp.insert(uid);
-        updateAppProcess();
+    // second: 解冻时长上限, 静默后会提前冻结  isQuiescence 为 false 时到期才冻结, 也不计入整体解冻开销
+    void unFreezerTemporary(int uid, int second, const bool isQuiescence = true) {
+        if (!managedApp.contains(uid)) return;
+
+        auto& appInfo = managedApp[uid];
+        if (appInfo.isFreeze) {
+            if (!appInfo.isPermissive)
+                setStandbyByLocalSocket(STANDBY::ACTIVE, appInfo);
+            const int num = handleProcess(appInfo, false);
+            freezeit.debugFmt("☀️临时解冻 %s %d进程", appInfo.label.c_str(), num);
+            appInfo.startTimestamp = time(nullptr);
+            appInfo.isFreeze = false;
+        }
         pendingHandleList[uid] = second;
+        updatePendingByLocalSocket();
+
+        if (!isQuiescence) return;
+        fullThawStart[uid] = { getAppCpuTimeMs(appInfo), time(nullptr) };
+        startQuiescence(appInfo);
+    }
+
+    void startQuiescence(const appInfoStruct& appInfo) {
+        lock_guard<mutex> lock(quiescenceMutex);
+        quiescenceList[appInfo.uid] = { getAppCpuTimeMs(appInfo), 0 };
+    }
+
+    // 采样一次 静默的应用/进程将剩余解冻时间缩短为1秒, 由 processPendingApp/processPartialThaw 冻结
+    void sampleQuiescence() {
+        {
+            lock_guard<mutex> lock(quiescenceMutex);
+            auto it = quiescenceList.begin();
+            while (it != quiescenceList.end()) {
+                const int uid = it->first;
+                auto& info = it->second;
+                auto pendingIt = pendingHandleList.find(uid);
+                if (pendingIt == pendingHandleList.end() || managedApp[uid].isFreeze) { // 已冻结或转为前台
+                    it = quiescenceList.erase(it);
+                    continue;
+                }
+
+                const int cpuTimeMs = getAppCpuTimeMs(managedApp[uid]);
+                if (cpuTimeMs != info.lastCpuMs) {
+                    info.lastCpuMs = cpuTimeMs;
+                    info.flatCnt = 0;
+                }
+                else if (++info.flatCnt >= QUIESCENCE_FLAT_CNT) {
+                    if (pendingIt->second > 1) {
+                        quiescenceSavedSec += pendingIt->second - 1;
+                        pendingIt->second = 1;
+                        quiescenceRefreezeCnt++;
+                    }
+                    it = quiescenceList.erase(it);
+                    continue;
+                }
+                it++;
+            }
+        }
+
+        lock_guard<mutex> lock(partialThawMutex);
+        for (auto& [pid, info] : partialThawList) {
+            if (info.remainSec <= 1) continue;
+
+            const int cpuTimeMs = Utils::getProcCpuTimeMs(pid);
+            if (cpuTimeMs != info.lastCpuMs) {
+                info.lastCpuMs = cpuTimeMs;
+                info.flatCnt = 0;
+            }
+            else if (++info.flatCnt >= QUIESCENCE_FLAT_CNT) {
+                quiescenceSavedSec += info.remainSec - 1;
+                info.remainSec = 1;
+                quiescenceRefreezeCnt++;
+            }
+        }
+    }
+
+    // 代替循环线程的1秒休眠, 每100ms处理Binder事件及预解冻, 有解冻中的应用时同时做一次静默检测
+    void sleepWithQuiescence() {
+        for (int ms = 0; ms < 1000; ms += QUIESCENCE_SAMPLE_MS) {
+            bool isEmpty;
+            {
+                lock_guard<mutex> lock(quiescenceMutex);
+                lock_guard<mutex> lockPartial(partialThawMutex);
+                isEmpty = quiescenceList.empty() && partialThawList.empty();
+            }
+            Utils::sleep_ms(QUIESCENCE_SAMPLE_MS);
+            processBinderEvents(); // Binder事件需尽快处理, 不等待整秒
+            if (isPreThawRequested.exchange(false)) preThawLikelyApps();
+            if (!isEmpty) sampleQuiescence();
+        }
+    }
+
+    int getAppCpuTimeMs(const appInfoStruct& appInfo) {
+        int total = 0;
+        for (const int pid : appInfo.pids) {
+            const int ms = Utils::getProcCpuTimeMs(pid);
+            if (ms > 0) total += ms;
+        }
+        return total;
+    }
+
+    // 局部临时解冻: 只解冻接收Binder的进程, 重复事件则延长解冻时间
+    void partialThaw(const appInfoStruct& appInfo, const int pid, const int second) {
+        lock_guard<mutex> lock(partialThawMutex);
+
+        auto it = partialThawList.find(pid);
+        if (it != partialThawList.end()) {
+            auto& info = it->second;
+            info.thawSec += second - info.remainSec > 0 ? second - info.remainSec : 0;
+            info.remainSec = max(info.remainSec, second);
+            info.flatCnt = 0;
+            partialThawExtendCnt++;
+            return;
+        }
+
+        handlePids(appInfo, { pid }, false);
+        const int cpuTimeMs = Utils::getProcCpuTimeMs(pid);
+        partialThawList[pid] = { appInfo.uid, second, second, cpuTimeMs, cpuTimeMs, 0 };
+        partialThawCnt++;
+        partialThawSkipPidCnt += appInfo.pids.size() > 1 ? appInfo.pids.size() - 1 : 0;
+    }
+
+    // 局部解冻到期后重新冻结 call once per 1sec
+    void processPartialThaw() {
+        lock_guard<mutex> lock(partialThawMutex);
+
+        auto it = partialThawList.begin();
+        while (it != partialThawList.end()) {
+            auto& info = it->second;
+            if (--info.remainSec > 0) {
+                it++;
+                continue;
+            }
+
+            const int pid = it->first;
+            auto& appInfo = managedApp[info.uid];
+            if (appInfo.isFreeze && !curForegroundApp.contains(info.uid) && !pendingHandleList.contains(info.uid)) {
+                const int cpuTimeNow = Utils::getProcCpuTimeMs(pid);
+                if (cpuTimeNow >= 0) {
+                    if (handlePids(appInfo, { pid }, true) < 0) { // Binder仍有事务, 下一秒重试
+                        info.remainSec = 1;
+                        it++;
+                        continue;
+                    }
+
+                    const int usedMs = max(0, cpuTimeNow - info.cpuTimeStart);
+                    partialThawCpuUsedMs += usedMs;
+
+                    // 按该应用整体临时解冻时的平均CPU开销估算节省的时间
+                    const auto costIt = fullThawCost.find(info.uid);
+                    if (costIt != fullThawCost.end() && costIt->second.thawSec > 0) {
+                        const int fullMs = costIt->second.cpuTimeMs * info.thawSec / costIt->second.thawSec;
+                        if (fullMs > usedMs) partialThawCpuSavedMs += fullMs - usedMs;
+                        partialThawEstCnt++;
+                        freezeit.debugFmt("局部解冻 [%s:%d] 结束, 解冻%d秒 CPU %dms, 整体解冻预计 %dms",
+                            appInfo.label.c_str(), pid, info.thawSec, usedMs, fullMs);
+                    }
+                    else {
+                        freezeit.debugFmt("局部解冻 [%s:%d] 结束, 解冻%d秒 CPU %dms",
+                            appInfo.label.c_str(), pid, info.thawSec, usedMs);
+                    }
+                }
+            }
+            it = partialThawList.erase(it);
+        }
+    }
+
+    bool isPartialThawing(const int pid) {
+        lock_guard<mutex> lock(partialThawMutex);
+        return partialThawList.contains(pid);
     }
 
     map<int, vector<int>> getRunningPids(set<int>& uidSet) {
@@ -348,11 +713,15 @@ public:
     }
 
     void handleFreezer(const appInfoStruct& appInfo, const bool freeze) {
+        handleFreezer(appInfo, appInfo.pids, freeze);
+    }
+
+    void handleFreezer(const appInfoStruct& appInfo, const vector<int>& pids, const bool freeze) {
         char path[256];
 
         switch (workMode) {
         case WORK_MODE::V2FROZEN: {
-            for (const int pid : appInfo.pids) {
+            for (const int pid : pids) {
                 if (!Utils::writeInt(freeze ? cgroupV2FrozenPath : cgroupV2UnfrozenPath, pid))
                     freezeit.logFmt("%s [%s PID:%d] 失败(V2FROZEN)",
                         freeze ? "冻结" : "解冻", appInfo.label.c_str(), pid);
@@ -360,7 +729,7 @@ public:
         } break;
 
         case WORK_MODE::V2UID: {
-            for (const int pid : appInfo.pids) {
+            for (const int pid : pids) {
                 if (V2UIDSpareMode)
                     FastSnprintf(path, sizeof(path), cgroupV2SpaceUidPidPath, 
                         appInfo.isSystemApp ? "system" : "apps", appInfo.uid, pid);
@@ -375,7 +744,7 @@ public:
         // 本函数只处理Freezer模式，其他冻结模式不应来到此处
         default: {
             if (workMode == WORK_MODE::V1FROZEN) {
-                for (const int pid : appInfo.pids) {
+                for (const int pid : pids) {
                     if (!Utils::writeInt(freeze ? cgroupV1FrozenPath : cgroupV1UnfrozenPath, pid))
                         freezeit.logFmt("%s [%s PID:%d] 失败(V1FROZEN)",
                             freeze ? "冻结" : "解冻", appInfo.label.c_str(), pid);
@@ -387,12 +756,430 @@ public:
         }
     }
 
+    // list 为空格/换行分隔的控制器列表, 如 "cpuset cpu io memory pids"
+    static bool hasController(const char* list, const char* name) {
+        const size_t len = strlen(name);
+        for (const char* ptr = strstr(list, name); ptr; ptr = strstr(ptr + 1, name)) {
+            if ((ptr == list || ptr[-1] == ' ') && (ptr[len] == ' ' || ptr[len] == '\n' || ptr[len] == 0))
+                return true;
+        }
+        return false;
+    }
+
+    // cgroup v2 某层的 subtree_control 是否已启用控制器, 其子层 (uid_xxx) 才会出现 cpu.max 等接口
+    // 只检查不写入: 在根部启用会让所有应用及系统分组都按 cpu.weight 分配CPU, 改变整机调度
+    static bool isV2ControllerDelegated(const char* dir, const char* name) {
+        char path[128], buff[256];
+        FastSnprintf(path, sizeof(path), "%s/cgroup.subtree_control", dir);
+        return Utils::readString(path, buff, sizeof(buff) - 1) && hasController(buff, name);
+    }
+
+    // V1: 在 mount 下创建限制分组, 返回是否可用
+    bool createV1Group(const char* mount, const char* group) {
+        char path[128];
+        FastSnprintf(path, sizeof(path), "%s%s", mount, group);
+        mkdir(path, 0666);
+        FastSnprintf(path, sizeof(path), "%s%s/cgroup.procs", mount, group);
+        return !access(path, F_OK);
+    }
+
+    void writeV1Group(const char* mount, const char* group, const char* file, const char* value) {
+        char path[128];
+        FastSnprintf(path, sizeof(path), "%s%s/%s", mount, group, file);
+        if (!access(path, F_OK))
+            Utils::writeString(path, value);
+    }
+
+    // 检查 v2 memory 控制器是否已下放到应用分组, 供内存上限/回收/峰值统计使用
+    // 不自行开启: 开启会为每个 uid 分组创建 memcg, lmkd 及系统并不预期
+    void probeMemV2() {
+        if (isMemProbed) return;
+        isMemProbed = true;
+
+        isMemV2Ready = isV2ControllerDelegated("/sys/fs/cgroup", "memory") &&
+            (!V2UIDSpareMode || isV2ControllerDelegated("/sys/fs/cgroup/apps", "memory"));
+    }
+
+    void initRestrictCgroup() {
+        if (isRestrictInit) return;
+        isRestrictInit = true;
+
+        // v2 的 cpu/io 控制器须由系统预先下放到 uid 分组, 不自行开启; 未下放则使用 v1 /dev/cpuctl 的独立限制分组
+        isCpuV2Ready = isV2ControllerDelegated("/sys/fs/cgroup", "cpu") &&
+            (!V2UIDSpareMode || isV2ControllerDelegated("/sys/fs/cgroup/apps", "cpu"));
+        isIoV2Ready = isV2ControllerDelegated("/sys/fs/cgroup", "io") &&
+            (!V2UIDSpareMode || isV2ControllerDelegated("/sys/fs/cgroup/apps", "io"));
+        probeMemV2();
+
+        if (!access("/dev/cpuctl/cgroup.procs", F_OK)) {
+            if (createV1Group("/dev/cpuctl", cpuctlThrottleGroup)) {
+                char value[16];
+                FastSnprintf(value, sizeof(value), "%d", 1024 * THROTTLE_CPU_WEIGHT / 100);
+                writeV1Group("/dev/cpuctl", cpuctlThrottleGroup, "cpu.shares", value);
+                writeV1Group("/dev/cpuctl", cpuctlThrottleGroup, "cpu.cfs_period_us", "100000");
+                writeV1Group("/dev/cpuctl", cpuctlThrottleGroup, "cpu.cfs_quota_us", "20000");
+                isCpuctlReady = true;
+            }
+            if (createV1Group("/dev/cpuctl", cpuctlLittleGroup)) {
+                char path[128];
+                FastSnprintf(path, sizeof(path), "/dev/cpuctl%s/cpu.uclamp.max", cpuctlLittleGroup);
+                isCpuctlLittleReady = !access(path, F_OK);
+                writeV1Group("/dev/cpuctl", cpuctlLittleGroup, "cpu.uclamp.max", LITTLE_UCLAMP_MAX);
+            }
+        }
+
+        // 小核限制: 只有存在多个集群时才有意义
+        const auto& littleCores = systemTools.littleCoreList;
+        if (littleCores.length() && !access("/dev/cpuset/cgroup.procs", F_OK) &&
+            createV1Group("/dev/cpuset", cpusetLittleGroup)) {
+            char mems[32];
+            if (Utils::readString("/dev/cpuset/mems", mems, sizeof(mems) - 1) == 0) strcpy(mems, "0");
+            writeV1Group("/dev/cpuset", cpusetLittleGroup, "mems", mems); // 需先设置 mems 才能加入进程
+            writeV1Group("/dev/cpuset", cpusetLittleGroup, "cpus", littleCores.c_str());
+            isCpusetLittleReady = true;
+        }
+
+        if (isCpuV2Ready)
+            freezeit.logFmt("限制模式: 使用 cgroup v2 cpu.max%s", isIoV2Ready ? " + io.weight" :
+                ", io控制器未下放到应用分组, 不限制IO");
+        else if (isCpuctlReady)
+            freezeit.log("限制模式: cgroup v2 未对应用分组启用cpu控制器(不会自动开启, 以免改变整机CPU分配), "
+                "使用 /dev/cpuctl 独立限制分组");
+        else
+            freezeit.log("限制模式: cgroup v2 未对应用分组启用cpu控制器(不会自动开启), 且无 /dev/cpuctl, 限制CPU将不生效");
+
+        if (isCpusetLittleReady)
+            freezeit.logFmt("限制模式: 小核运行使用核心 [%s]", littleCores.c_str());
+        else
+            freezeit.log("限制模式: 只有单个CPU集群或cpuset不可用, 小核运行将只限制uclamp");
+
+        char controllers[256];
+        const bool hasMemV2 = Utils::readString("/sys/fs/cgroup/cgroup.controllers", controllers, sizeof(controllers) - 1) &&
+            hasController(controllers, "memory");
+        if (isMemV2Ready)
+            freezeit.log("限制模式: 内存上限使用 cgroup v2 memory.high");
+        else if (!access("/dev/memcg/apps", F_OK))
+            freezeit.logFmt("限制模式: %s, 内存上限使用 v1 memory.soft_limit_in_bytes", hasMemV2 ?
+                "cgroup v2 未对应用分组启用memory控制器(不会自动开启, 以免为所有分组创建memcg)" : "memory控制器位于v1");
+        else if (hasMemV2)
+            freezeit.log("限制模式: cgroup v2 未对应用分组启用memory控制器(不会自动开启, 以免为所有分组创建memcg), "
+                "且无 per-app v1 memcg, 内存上限将不生效");
+        else
+            freezeit.log("限制模式: 未找到 per-app memcg, 内存上限将不生效");
+    }
+
+    // V1: 读取进程在某控制器下所在的分组, 如 "/background"
+    bool getV1Group(const int pid, const char* controller, char* group, const size_t size) {
+        char path[32], buff[1024];
+        FastSnprintf(path, sizeof(path), "/proc/%d/cgroup", pid);
+        if (Utils::readString(path, buff, sizeof(buff) - 1) == 0) return false;
+
+        // 每行格式 "3:cpu,cpuacct:/background"
+        const size_t nameLen = strlen(controller);
+        for (char* line = buff; line && *line; ) {
+            char* lineEnd = strchr(line, '\n');
+            if (lineEnd) *lineEnd = 0;
+
+            char* ptr = strchr(line, ':');
+            char* pathPtr = ptr ? strchr(ptr + 1, ':') : nullptr;
+            if (pathPtr) {
+                for (ptr++; ptr < pathPtr; ) {
+                    const char* comma = static_cast<const char*>(memchr(ptr, ',', pathPtr - ptr));
+                    const char* nameEnd = comma ? comma : pathPtr;
+                    if (static_cast<size_t>(nameEnd - ptr) == nameLen && !strncmp(ptr, controller, nameLen)) {
+                        strncpy(group, pathPtr + 1, size - 1);
+                        group[size - 1] = 0;
+                        return group[0] != 0;
+                    }
+                    ptr = const_cast<char*>(nameEnd) + 1;
+                }
+            }
+            line = lineEnd ? lineEnd + 1 : nullptr;
+        }
+        return false;
+    }
+
+    // V1: 把进程移入限制分组, 记录原分组以便恢复
+    void moveToV1Group(const appInfoStruct& appInfo, const char* controller, const char* mount, const char* group,
+        map<int, string>& origGroup) {
+        char path[128], curGroup[128];
+        FastSnprintf(path, sizeof(path), "%s%s/cgroup.procs", mount, group);
+        for (const int pid : appInfo.pids) {
+            if (!getV1Group(pid, controller, curGroup, sizeof(curGroup))) continue;
+            if (!strcmp(curGroup, group)) continue;
+            if (!Utils::writeInt(path, pid)) continue;
+            origGroup[pid] = curGroup;
+        }
+    }
+
+    // V1: 仍在限制分组的进程移回原分组, 已被系统移到其他分组(如 top-app)的保持不动
+    void restoreV1Group(const appInfoStruct& appInfo, const char* controller, const char* mount,
+        map<int, string>& origGroup) {
+        char path[128], curGroup[128];
+        for (const int pid : appInfo.pids) {
+            auto it = origGroup.find(pid);
+            if (it == origGroup.end()) continue;
+            if (getV1Group(pid, controller, curGroup, sizeof(curGroup)) &&
+                (!strcmp(curGroup, cpuctlThrottleGroup) || !strcmp(curGroup, cpuctlLittleGroup) ||
+                    !strcmp(curGroup, cpusetLittleGroup))) {
+                FastSnprintf(path, sizeof(path), "%s%s/cgroup.procs", mount, it->second == "/" ? "" : it->second.c_str());
+                Utils::writeInt(path, pid);
+            }
+            origGroup.erase(it);
+        }
+        erase_if(origGroup, [](const auto& item) { // 已结束的进程
+            char procPath[32];
+            FastSnprintf(procPath, sizeof(procPath), "/proc/%d", item.first);
+            return access(procPath, F_OK) != 0;
+        });
+    }
+
+    // 读取 uid_xxx/memory.pressure 中 some 行的 total (因内存回收停顿的累计时长), 不支持则返回 -1
+    int64_t getMemStallUs(const appInfoStruct& appInfo) {
+        if (!isMemV2Ready) return -1;
+
+        char path[128], buff[256];
+        getUidCgroupPath(appInfo, path, sizeof(path));
+        strcat(path, "/memory.pressure");
+        if (Utils::readString(path, buff, sizeof(buff) - 1) == 0) return -1;
+
+        const char* ptr = strstr(buff, "total=");
+        return ptr ? strtoll(ptr + 6, nullptr, 10) : -1;
+    }
+
+    // 应用当前内存占用(MiB), 取自 per-app memcg, 不支持则返回 -1
+    int getUidMemoryMiB(const appInfoStruct& appInfo) {
+        char path[128], buff[32];
+        if (isMemV2Ready) {
+            getUidCgroupPath(appInfo, path, sizeof(path));
+            strcat(path, "/memory.current");
+        }
+        else {
+            FastSnprintf(path, sizeof(path), "/dev/memcg/apps/uid_%d/memory.usage_in_bytes", appInfo.uid);
+        }
+        if (Utils::readString(path, buff, sizeof(buff) - 1) == 0) return -1;
+        return static_cast<int>(strtoll(buff, nullptr, 10) >> 20);
+    }
+
+    // 进入前台时重置内存峰值统计  V2 memory.peak 写入 reset 后只对该fd的读取生效(6.12+), 需保持打开到切后台
+    void resetForegroundPeak(const appInfoStruct& appInfo) {
+        lock_guard<mutex> lock(restrictMutex);
+        probeMemV2();
+
+        char path[128];
+        if (isMemV2Ready) {
+            if (auto it = foregroundPeakFd.find(appInfo.uid); it != foregroundPeakFd.end()) {
+                close(it->second);
+                foregroundPeakFd.erase(it);
+            }
+            if (!hasUidCgroup(appInfo)) return;
+
+            getUidCgroupPath(appInfo, path, sizeof(path));
+            strcat(path, "/memory.peak");
+            const int fd = open(path, O_RDWR | O_CLOEXEC);
+            if (fd < 0) return;
+            if (write(fd, "reset", 5) < 0) { // 旧内核不支持重置, 读取时退回 cgroup 生命周期内的峰值
+                close(fd);
+                return;
+            }
+            foregroundPeakFd[appInfo.uid] = fd;
+        }
+        else {
+            FastSnprintf(path, sizeof(path), "/dev/memcg/apps/uid_%d/memory.max_usage_in_bytes", appInfo.uid);
+            Utils::writeString(path, "0");
+        }
+    }
+
+    // 切到后台时读取前台期间的内存峰值(MiB), 不支持则返回 -1
+    int getForegroundPeakMiB(const appInfoStruct& appInfo) {
+        char path[128], buff[32];
+        ssize_t len = 0;
+        if (isMemV2Ready) {
+            if (auto it = foregroundPeakFd.find(appInfo.uid); it != foregroundPeakFd.end()) {
+                len = pread(it->second, buff, sizeof(buff) - 1, 0);
+                close(it->second);
+                foregroundPeakFd.erase(it);
+                if (len > 0) buff[len] = 0;
+            }
+            else {
+                getUidCgroupPath(appInfo, path, sizeof(path));
+                strcat(path, "/memory.peak");
+                len = Utils::readString(path, buff, sizeof(buff) - 1);
+            }
+        }
+        else {
+            FastSnprintf(path, sizeof(path), "/dev/memcg/apps/uid_%d/memory.max_usage_in_bytes", appInfo.uid);
+            len = Utils::readString(path, buff, sizeof(buff) - 1);
+        }
+        if (len <= 0) return -1;
+        return static_cast<int>(strtoll(buff, nullptr, 10) >> 20);
+    }
+
+    // 切到后台时记录前台期间的内存峰值
+    void recordForegroundPeak(const appInfoStruct& appInfo) {
+        lock_guard<mutex> lock(restrictMutex);
+        probeMemV2();
+
+        const int curMiB = getForegroundPeakMiB(appInfo);
+        if (curMiB <= 0) return;
+        auto& peakMiB = foregroundPeakMiB[appInfo.uid];
+        peakMiB = max(curMiB, peakMiB - peakMiB / 8); // 缓慢衰减, 跟随近期用量
+    }
+
+    // 读取 uid_xxx/cpu.stat 的 throttled_usec, 不支持则返回 -1
+    int64_t getThrottledUs(const appInfoStruct& appInfo) {
+        if (!isCpuV2Ready) return -1;
+
+        char path[128], buff[512];
+        getUidCgroupPath(appInfo, path, sizeof(path));
+        strcat(path, "/cpu.stat");
+        if (Utils::readString(path, buff, sizeof(buff) - 1) == 0) return -1;
+
+        const char* ptr = strstr(buff, "throttled_usec ");
+        return ptr ? strtoll(ptr + 15, nullptr, 10) : -1;
+    }
+
+    bool writeUidCgroup(const appInfoStruct& appInfo, const char* file, const char* value) {
+        char path[128];
+        getUidCgroupPath(appInfo, path, sizeof(path));
+        strcat(path, file);
+        return Utils::writeString(path, value);
+    }
+
+    bool hasUidCgroup(const appInfoStruct& appInfo) {
+        char path[128];
+        getUidCgroupPath(appInfo, path, sizeof(path));
+        return !access(path, F_OK);
+    }
+
+    void throttleCpu(const appInfoStruct& appInfo) {
+        if (isCpuV2Ready && hasUidCgroup(appInfo)) {
+            char value[32];
+            if (!writeUidCgroup(appInfo, "/cpu.max", THROTTLE_CPU_MAX))
+                freezeit.logFmt("限制 %s 失败(cpu.max)", appInfo.label.c_str());
+            FastSnprintf(value, sizeof(value), "%d", THROTTLE_CPU_WEIGHT);
+            writeUidCgroup(appInfo, "/cpu.weight", value);
+            if (isIoV2Ready) {
+                FastSnprintf(value, sizeof(value), "default %d", THROTTLE_IO_WEIGHT);
+                writeUidCgroup(appInfo, "/io.weight", value);
+            }
+        }
+        else if (isCpuctlReady) {
+            moveToV1Group(appInfo, "cpu", "/dev/cpuctl", cpuctlThrottleGroup, cpuctlOrigGroup);
+        }
+    }
+
+    // 小核运行: cpuset 限定在最低频集群, 再用 uclamp.max 压低调度器对其负载的估计, 避免被迁移/升频
+    void confineLittleCore(const appInfoStruct& appInfo) {
+        if (isCpusetLittleReady)
+            moveToV1Group(appInfo, "cpuset", "/dev/cpuset", cpusetLittleGroup, cpusetOrigGroup);
+
+        if (isCpuV2Ready && hasUidCgroup(appInfo))
+            writeUidCgroup(appInfo, "/cpu.uclamp.max", LITTLE_UCLAMP_MAX);
+        else if (isCpuctlLittleReady)
+            moveToV1Group(appInfo, "cpu", "/dev/cpuctl", cpuctlLittleGroup, cpuctlOrigGroup);
+    }
+
+    void limitMemory(const appInfoStruct& appInfo) {
+        const auto it = foregroundPeakMiB.find(appInfo.uid);
+        const int limitMiB = settings.getMemoryHighMiB(it == foregroundPeakMiB.end() ? -1 : it->second);
+        if (limitMiB <= 0) {
+            freezeit.logFmt("%s 尚无前台内存记录, 暂不设置内存上限", appInfo.label.c_str());
+            return;
+        }
+
+        char value[32], path[128];
+        FastSnprintf(value, sizeof(value), "%dM", limitMiB);
+        if (isMemV2Ready && hasUidCgroup(appInfo)) {
+            writeUidCgroup(appInfo, "/memory.high", value);
+        }
+        else {
+            FastSnprintf(path, sizeof(path), "/dev/memcg/apps/uid_%d/memory.soft_limit_in_bytes", appInfo.uid);
+            if (access(path, F_OK)) return;
+            Utils::writeString(path, value);
+        }
+        freezeit.debugFmt("%s 后台内存上限 %dMiB", appInfo.label.c_str(), limitMiB);
+    }
+
+    // 解除全部限制, 与当前模式无关 (模式可能已被修改)
+    void removeRestrict(const appInfoStruct& appInfo) {
+        if (isCpuV2Ready && hasUidCgroup(appInfo)) {
+            writeUidCgroup(appInfo, "/cpu.max", "max 100000");
+            writeUidCgroup(appInfo, "/cpu.weight", "100");
+            writeUidCgroup(appInfo, "/cpu.uclamp.max", "max");
+            if (isIoV2Ready) writeUidCgroup(appInfo, "/io.weight", "default 100");
+        }
+        if (isMemV2Ready && hasUidCgroup(appInfo)) {
+            writeUidCgroup(appInfo, "/memory.high", "max");
+        }
+        else {
+            char path[128];
+            FastSnprintf(path, sizeof(path), "/dev/memcg/apps/uid_%d/memory.soft_limit_in_bytes", appInfo.uid);
+            if (!access(path, F_OK)) Utils::writeString(path, "-1");
+        }
+        if (isCpuctlReady || isCpuctlLittleReady)
+            restoreV1Group(appInfo, "cpu", "/dev/cpuctl", cpuctlOrigGroup);
+        if (isCpusetLittleReady)
+            restoreV1Group(appInfo, "cpuset", "/dev/cpuset", cpusetOrigGroup);
+    }
+
+    // 限制模式: 不冻结进程, 只限制CPU/IO配额  返回受影响的进程数
+    int handleRestrict(appInfoStruct& appInfo, const bool restrict) {
+        lock_guard<mutex> lock(restrictMutex);
+        initRestrictCgroup();
+        if (!restrict && !appInfo.isRestricted) return 0;
+
+        if (restrict) {
+            if (appInfo.freezeMode == FREEZE_MODE::LITTLE_CORE) confineLittleCore(appInfo);
+            else if (appInfo.freezeMode == FREEZE_MODE::MEMORY_LIMIT) limitMemory(appInfo);
+            else throttleCpu(appInfo);
+        }
+        else {
+            removeRestrict(appInfo);
+        }
+
+        // 统计被限流/内存回收停顿的时长
+        auto& stat = restrictStat[appInfo.uid];
+        const int64_t throttledUs = getThrottledUs(appInfo);
+        const int64_t memStallUs = getMemStallUs(appInfo);
+        if (restrict) {
+            stat.throttledBaseUs = throttledUs;
+            stat.memStallBaseUs = memStallUs;
+        }
+        else {
+            if (0 <= stat.throttledBaseUs && stat.throttledBaseUs <= throttledUs)
+                stat.throttledMs += (throttledUs - stat.throttledBaseUs) / 1000;
+            if (0 <= stat.memStallBaseUs && stat.memStallBaseUs <= memStallUs)
+                stat.memStallMs += (memStallUs - stat.memStallBaseUs) / 1000;
+            stat.throttledBaseUs = stat.memStallBaseUs = -1;
+        }
+
+        appInfo.isRestricted = restrict;
+        return static_cast<int>(appInfo.pids.size());
+    }
+
+    // 当前这次限制期间 被限流/内存回收停顿 的时长(ms), 不支持则为 -1
+    void getCurRestrictMs(const appInfoStruct& appInfo, int64_t& throttledMs, int64_t& memStallMs) {
+        throttledMs = memStallMs = -1;
+        auto it = restrictStat.find(appInfo.uid);
+        if (it == restrictStat.end()) return;
+
+        const auto& stat = it->second;
+        const int64_t throttledUs = getThrottledUs(appInfo);
+        const int64_t memStallUs = getMemStallUs(appInfo);
+        if (0 <= stat.throttledBaseUs && stat.throttledBaseUs <= throttledUs)
+            throttledMs = (throttledUs - stat.throttledBaseUs) / 1000;
+        if (0 <= stat.memStallBaseUs && stat.memStallBaseUs <= memStallUs)
+            memStallMs = (memStallUs - stat.memStallBaseUs) / 1000;
+    }
+
     // < 0 : 冻结binder失败的pid， > 0 : 冻结成功的进程数
-    int handleProcess(appInfoStruct& appInfo, const bool freeze) {
+    int handleProcess(appInfoStruct& appInfo, const bool freeze, const bool refreshPids = true) {
         START_TIME_COUNT;
 
         if (freeze) {
-            getPids(appInfo);
+            if (refreshPids)
+                getPids(appInfo);
         }
         else {
             erase_if(appInfo.pids, [&appInfo](const int pid) {
@@ -410,7 +1197,8 @@ public:
 
         switch (appInfo.freezeMode) {
         case FREEZE_MODE::FREEZER: 
-        case FREEZE_MODE::FREEZER_BREAK: {
+        case FREEZE_MODE::FREEZER_BREAK:
+        case FREEZE_MODE::SCREENOFF: {
             if (workMode != WORK_MODE::GLOBAL_SIGSTOP) {
                 if (settings.enableBinderFreezer) {
                     const int res = handleBinder(appInfo, freeze);
@@ -437,7 +1225,14 @@ public:
             return 0;
         }
 
-        default: { // 刚刚切到白名单，但仍在 pendingHandleList 时，就会执行到这里
+        case FREEZE_MODE::THROTTLE_CPU:
+        case FREEZE_MODE::LITTLE_CORE:
+        case FREEZE_MODE::MEMORY_LIMIT:
+            return handleRestrict(appInfo, freeze);
+
+        default: {
+            if (!freeze && appInfo.isRestricted) // 已从限制模式切换到其他模式
+                handleRestrict(appInfo, false); // 刚刚切到白名单，但仍在 pendingHandleList 时，就会执行到这里
             //freezeit.logFmt("不再冻结此应用：%s %s", appInfo.label.c_str(),
             //    getModeText(appInfo.freezeMode).c_str());
             return 0;
@@ -446,25 +1241,18 @@ public:
 
         if (settings.isWakeupEnable()) {
             // 无论冻结还是解冻都要清除 解冻时间线上已设置的uid
-            if(0 <= appInfo.timelineUnfrozenIdx && appInfo.timelineUnfrozenIdx < 4096)
-                unfrozenTimeline[appInfo.timelineUnfrozenIdx] = 0;
+            removeTimeline(appInfo);
 
             // 冻结就需要在 解冻时间线 插入下一次解冻的时间
-            if (freeze && appInfo.pids.size() && appInfo.isSignalOrFreezer()) {
-                int nextIdx = (timelineIdx + settings.getWakeupTimeout()) & 0x0FFF; // [ %4096]
-                while (unfrozenTimeline[nextIdx])
-                    nextIdx = (nextIdx + 1) & 0x0FFF;
-                appInfo.timelineUnfrozenIdx = nextIdx;
-                unfrozenTimeline[nextIdx] = appInfo.uid;
-            }
-            else {
+            if (freeze && appInfo.pids.size() && appInfo.isSignalOrFreezer())
+                insertTimeline(appInfo, getAppWakeupInterval(appInfo));
+            else
                 appInfo.timelineUnfrozenIdx = -1;
-            }
         }
         
         if (freeze && appInfo.needBreakNetwork()) 
             BreakNetWork(appInfo);
-        else if(freeze && settings.enableBreakNetWork) 
+        else if(freeze && settings.enableBreakNetWork && !appInfo.isScreenOffMode()) // 息屏冻结的应用亮屏后需立即恢复连接
             BreakNetWork(appInfo);
         
         END_TIME_COUNT;
@@ -472,6 +1260,19 @@ public:
     }
 
     void BreakNetWork(appInfoStruct& appInfo) {
+        if (settings.breakNetworkMode == 0) {
+            int foundCnt = 0;
+            const int closedCnt = systemTools.destroySocketsByUid(appInfo.uid, foundCnt);
+            if (closedCnt >= 0) {
+                if (foundCnt)
+                    freezeit.logFmt("断网成功: %s 关闭连接 %d/%d", appInfo.label.c_str(), closedCnt, foundCnt);
+                else
+                    freezeit.debugFmt("断网: %s 无网络连接", appInfo.label.c_str());
+                return;
+            }
+            freezeit.logFmt("原生断网失败, 改用Xposed断网: %s", appInfo.label.c_str());
+        }
+
         const auto ret = systemTools.breakNetworkByLocalSocket(appInfo.uid);
         switch (static_cast<REPLY>(ret)) {
         case REPLY::SUCCESS:
@@ -558,88 +1359,196 @@ public:
     }
 
 
-    // 临时解冻：检查已冻结应用的进程状态wchan，若有未冻结进程则临时解冻
-    void checkUnFreeze() {
-        START_TIME_COUNT;
-
-        if (--refreezeSecRemain > 0) return;
-        refreezeSecRemain = 3600;// 固定每小时检查一次
-
-        lock_guard<mutex> lock(naughtyMutex);
-
-        if (naughtyApp.size() == 0) {
-            DIR* dir = opendir("/proc");
-            if (dir == nullptr) {
-                char errTips[256];
-                FastSnprintf(errTips, sizeof(errTips), "错误: %s() [%d]:[%s]", __FUNCTION__, errno,
-                    strerror(errno));
-                fprintf(stderr, "%s", errTips);
-                freezeit.log(errTips);
-                return;
-            }
+    static bool isFrozenWchan(const char* wchan) {
+        return !strcmp(wchan, v2wchan) || !strcmp(wchan, v1wchan) || !strcmp(wchan, SIGSTOPwchan) ||
+            !strcmp(wchan, v2xwchan) || !strcmp(wchan, pStopwchan);
+    }
 
-            struct dirent* file;
-            while ((file = readdir(dir)) != nullptr) {
-                if (file->d_type != DT_DIR || file->d_name[0] < '0' || file->d_name[0] > '9') continue;
+    // 进程是否属于该应用 (UID + cmdline包名)
+    static bool isAppProcess(const appInfoStruct& appInfo, const int pid) {
+        char path[64];
+        FastSnprintf(path, sizeof(path), "/proc/%d", pid);
 
-                const int pid = Fastatoi(file->d_name);
-                if (pid <= 100) continue;
+        struct stat statBuf;
+        if (stat(path, &statBuf) || statBuf.st_uid != (uid_t)appInfo.uid) return false;
 
-                char fullPath[64];
-                memcpy(fullPath, "/proc/", 6);
-                memcpy(fullPath + 6, file->d_name, 6);
+        FastSnprintf(path, sizeof(path), "/proc/%d/cmdline", pid);
+        char readBuff[256];
+        if (Utils::readString(path, readBuff, sizeof(readBuff)) == 0) return false;
 
-                struct stat statBuf;
-                if (stat(fullPath, &statBuf))continue;
-                const int uid = statBuf.st_uid;
-                if (!managedApp.contains(uid) || pendingHandleList.contains(uid) || curForegroundApp.contains(uid))
-                    continue;
+        const string& package = appInfo.package;
+        if (strncmp(readBuff, package.c_str(), package.length())) return false;
+        const char endChar = readBuff[package.length()]; // 特例 com.android.chrome_zygote 无法binder冻结
+        return endChar == ':' || endChar == 0;
+    }
 
-                auto& appInfo = managedApp[uid];
-                if (appInfo.isWhitelist())
-                    continue;
+    // 只对指定进程执行冻结/解冻, 不改变应用整体的冻结状态
+    // 0成功  小于0为冻结Binder失败的pid, 此时已撤消其他进程的Binder冻结, 且未冻结任何进程
+    int handlePids(const appInfoStruct& appInfo, const vector<int>& pids, const bool freeze) {
+        if (pids.empty()) return 0;
 
-                strcat(fullPath + 8, "/cmdline");
-                char readBuff[256];
-                if (Utils::readString(fullPath, readBuff, sizeof(readBuff)) == 0)continue;
-                const auto& package = appInfo.package;
-                if (strncmp(readBuff, package.c_str(), package.length())) continue;
-                const char endChar = readBuff[package.length()]; // 特例 com.android.chrome_zygote 无法binder冻结
-                if (endChar != ':' && endChar != 0)continue;
+        if (appInfo.isTerminateMode()) {
+            if (freeze)
+                for (const int pid : pids)
+                    kill(pid, SIGKILL);
+            return 0;
+        }
 
-                memcpy(fullPath + 6, file->d_name, 6);
-                memcpy(fullPath + 12, "/wchan", 7);
-                if (Utils::readString(fullPath, readBuff, sizeof(readBuff)) == 0)continue;
-                if (strcmp(readBuff, v2wchan) && strcmp(readBuff, v1wchan) && strcmp(readBuff, SIGSTOPwchan) &&
-                    strcmp(readBuff, v2xwchan) && strcmp(readBuff, pStopwchan)) {
-                    naughtyApp.insert(uid);
-                }
-            }
-            closedir(dir);
+        if (appInfo.isSignalMode() || workMode == WORK_MODE::GLOBAL_SIGSTOP) {
+            for (const int pid : pids)
+                kill(pid, freeze ? SIGSTOP : SIGCONT);
+            return 0;
         }
 
-        if (naughtyApp.size()) {
-            stackString<1024> tmp("临时解冻");
-            for (const auto uid : naughtyApp) {
-                tmp.append(' ').append(managedApp[uid].label.c_str());
+        if (settings.enableBinderFreezer && bs.fd > 0) {
+            binder_freeze_info binderInfo{ .pid = 0u, .enable = freeze ? 1u : 0u, .timeout_ms = 0u };
+            for (size_t i = 0; i < pids.size(); i++) {
+                binderInfo.pid = pids[i];
+                if (ioctl(bs.fd, BINDER_FREEZE, &binderInfo) == 0) continue;
+
+                const int errorCode = errno;
+                freezeit.debugFmt("%s Binder [%s:%d] ErrorCode:%d", freeze ? "冻结" : "解冻",
+                    appInfo.label.c_str(), pids[i], errorCode);
+                if (!freeze) continue;
+
+                // EAGAIN: 仍有传输事务, 此时冻结进程会让同步调用方卡住, 撤消已冻结的Binder
+                binderInfo.enable = 0;
+                for (size_t j = 0; j < i; j++) {
+                    binderInfo.pid = pids[j];
+                    if (ioctl(bs.fd, BINDER_FREEZE, &binderInfo) < 0)
+                        freezeit.logFmt("撤消冻结：解冻恢复Binder发生错误：[%s:%d] ErrorCode:%d",
+                            appInfo.label.c_str(), pids[j], errno);
+                }
+                return -pids[i];
             }
-            freezeit.log(tmp.c_str(), tmp.length);
-            unFreezerTemporary(naughtyApp);
-            naughtyApp.clear();
         }
+        handleFreezer(appInfo, pids, freeze);
+        return 0;
+    }
 
-        END_TIME_COUNT;
+    // 从 cgroup 的 uid_xxx/pid_xxx 目录找出该应用冻结后新启动的进程, 无需遍历整个 /proc
+    void getUidCgroupPath(const appInfoStruct& appInfo, char* path, const size_t size) {
+        if (V2UIDSpareMode)
+            FastSnprintf(path, size, "/sys/fs/cgroup/%s/uid_%d",
+                appInfo.isSystemApp ? "system" : "apps", appInfo.uid);
+        else
+            FastSnprintf(path, size, "/sys/fs/cgroup/uid_%d", appInfo.uid);
     }
 
-    bool mountFreezerV1() {
-        if (!access("/dev/MoWei_freezer", F_OK)) // 已挂载
-            return true;
+    void getNewPidsByCgroup(const appInfoStruct& appInfo, vector<int>& newPids) {
+        char path[64];
+        getUidCgroupPath(appInfo, path, sizeof(path));
 
-        // https://man7.org/linux/man-pages/man7/cgroups.7.html
-        // https://www.kernel.org/doc/Documentation/cgroup-v1/freezer-subsystem.txt
-        // https://www.containerlabs.kubedaily.com/LXC/Linux%20Containers/The-cgroup-freezer-subsystem.html
+        DIR* dir = opendir(path);
+        if (dir == nullptr) return;
 
-        mkdir("/dev/MoWei_freezer", 0666);
+        struct dirent* file;
+        while ((file = readdir(dir)) != nullptr) {
+            if (file->d_type != DT_DIR || strncmp(file->d_name, "pid_", 4)) continue;
+
+            const int pid = Fastatoi(file->d_name + 4);
+            if (pid <= 100) continue;
+            if (std::find(appInfo.pids.begin(), appInfo.pids.end(), pid) != appInfo.pids.end()) continue;
+            if (isAppProcess(appInfo, pid))
+                newPids.emplace_back(pid);
+        }
+        closedir(dir);
+    }
+
+    // 校验已冻结应用: 已结束的进程移出列表, 返回未处于冻结状态(逃逸)的进程
+    vector<int> getEscapedPids(appInfoStruct& appInfo) {
+        vector<int> escapedPids;
+
+        erase_if(appInfo.pids, [&](const int pid) {
+            char path[32];
+            FastSnprintf(path, sizeof(path), "/proc/%d/wchan", pid);
+
+            char wchan[128];
+            if (Utils::readString(path, wchan, sizeof(wchan)) == 0)
+                return true; // 进程已结束
+
+            if (!isFrozenWchan(wchan) && !isPartialThawing(pid))
+                escapedPids.emplace_back(pid);
+            return false;
+        });
+
+        getNewPidsByCgroup(appInfo, escapedPids);
+        return escapedPids;
+    }
+
+    // 定时压制: 按设置的周期只校验已冻结的应用, 逃逸进程直接重新冻结, 不走完整的解冻-冻结流程
+    void checkUnFreeze() {
+        if (refreezeSecRemain > settings.getRefreezeTimeout())
+            refreezeSecRemain = settings.getRefreezeTimeout(); // 设置已变更
+
+        if (--refreezeSecRemain > 0) return;
+        if (isUserActive()) { // 用户正在操作 稍后再扫描
+            refreezeSecRemain = 1;
+            return;
+        }
+        refreezeSecRemain = settings.getRefreezeTimeout();
+
+        START_TIME_COUNT;
+
+        lock_guard<mutex> lock(naughtyMutex);
+
+        int appCnt = 0, pidCnt = 0, failCnt = 0;
+        stackString<1024> tmp("定时压制");
+
+        if (settings.isRefreezeEnable()) {
+            for (auto& appInfo : managedApp.appInfoMap) {
+                if (appInfo.uid < ManagedApp::UID_START || !appInfo.isFreeze) continue;
+                if (pendingHandleList.contains(appInfo.uid) || curForegroundApp.contains(appInfo.uid)) continue;
+
+                const auto escapedPids = getEscapedPids(appInfo);
+                if (escapedPids.empty()) continue;
+
+                const int res = handlePids(appInfo, escapedPids, true);
+                for (const int pid : escapedPids)
+                    if (std::find(appInfo.pids.begin(), appInfo.pids.end(), pid) == appInfo.pids.end())
+                        appInfo.pids.emplace_back(pid);
+
+                if (res < 0) { // Binder仍有事务, 未压制, 下次再试
+                    failCnt++;
+                    tmp.append(' ').append(appInfo.label.c_str()).append("(Binder:").append(-res).append(')');
+                    continue;
+                }
+                appCnt++;
+                pidCnt += escapedPids.size();
+                tmp.append(' ').append(appInfo.label.c_str()).append('(').append((int)escapedPids.size()).append(')');
+                naughtyApp.erase(appInfo.uid);
+            }
+        }
+
+        // printProcState() 发现的未冻结应用(如后台被拉起, 从未进入冻结), 直接加入待冻结列队
+        for (const auto uid : naughtyApp) {
+            if (!managedApp.contains(uid) || pendingHandleList.contains(uid) || curForegroundApp.contains(uid))
+                continue;
+            pendingHandleList[uid] = 0;
+            tmp.append(' ').append(managedApp[uid].label.c_str());
+        }
+        naughtyApp.clear();
+
+        if (appCnt)
+            tmp.appendFmt(" | 共重新压制 %d应用 %d进程", appCnt, pidCnt);
+        else if (failCnt == 0)
+            tmp.append(" | 未发现逃逸进程");
+        if (failCnt)
+            tmp.appendFmt(" | %d应用Binder仍有事务, 暂未压制", failCnt);
+        freezeit.log(tmp.c_str(), tmp.length);
+
+        END_TIME_COUNT;
+    }
+
+    bool mountFreezerV1() {
+        if (!access("/dev/MoWei_freezer", F_OK)) // 已挂载
+            return true;
+
+        // https://man7.org/linux/man-pages/man7/cgroups.7.html
+        // https://www.kernel.org/doc/Documentation/cgroup-v1/freezer-subsystem.txt
+        // https://www.containerlabs.kubedaily.com/LXC/Linux%20Containers/The-cgroup-freezer-subsystem.html
+
+        mkdir("/dev/MoWei_freezer", 0666);
         mount("freezer", "/dev/MoWei_freezer", "cgroup", 0, "freezer");
         usleep(1000 * 100);
         mkdir("/dev/MoWei_freezer/frozen", 0666);
@@ -746,7 +1655,7 @@ public:
             if (!managedApp.contains(uid)) continue;
 
             auto& appInfo = managedApp[uid];
-            if (appInfo.isWhitelist()) continue;
+            if (appInfo.isWhitelist() && !(appInfo.isScreenOffMode() && appInfo.isFreeze)) continue;
 
             memcpy(fullPath + 6 + len, "/cmdline", 9);
             char readBuff[256]; // now is cmdline Content
@@ -787,10 +1696,16 @@ public:
 
             if (pendingHandleList.contains(uid)) {
                 const auto secRemain = pendingHandleList[uid];
+                const char* action = appInfo.isRestrictMode() ? "限制" : "冻结";
                 if (secRemain < 60)
-                    stateStr.appendFmt("%5d %4d ⏳%d秒后冻结 %s\n", pid, memMiB, secRemain, label.c_str());
+                    stateStr.appendFmt("%5d %4d ⏳%d秒后%s %s\n", pid, memMiB, secRemain, action, label.c_str());
                 else
-                    stateStr.appendFmt("%5d %4d ⏳%d分后冻结 %s\n", pid, memMiB, secRemain / 60, label.c_str());
+                    stateStr.appendFmt("%5d %4d ⏳%d分后%s %s\n", pid, memMiB, secRemain / 60, action, label.c_str());
+                continue;
+            }
+
+            if (appInfo.isRestricted) { // 限制模式本就保持运行, 不算异常
+                stateStr.appendFmt("%5d %4d 🐢限制中 %s\n", pid, memMiB, label.c_str());
                 continue;
             }
 
@@ -842,13 +1757,82 @@ public:
         else {
 
             if (naughtyApp.size()) {
-                stateStr.append("\n 发现 [未冻结状态] 的进程, 即将临时解冻\n");
+                stateStr.append("\n 发现 [未冻结状态] 的进程, 即将重新压制\n");
                 refreezeSecRemain = 0;
             }
 
             stateStr.appendFmt("\n总计 %d 应用 %d 进程, 占用内存 ", (int)uidSet.size(), (int)pidSet.size());
             stateStr.appendFmt("%.2f GiB", totalMiB / 1024.0);
 
+            if (partialThawCnt) {
+                stateStr.appendFmt("\n局部解冻 %d次 延长%d次, 免解冻 %d进程次", partialThawCnt, partialThawExtendCnt,
+                    partialThawSkipPidCnt);
+                stateStr.appendFmt(", CPU %dms", partialThawCpuUsedMs);
+                if (partialThawEstCnt)
+                    stateStr.appendFmt(", 其中%d次有整体解冻基线, 估算节省 %dms", partialThawEstCnt, partialThawCpuSavedMs);
+                else
+                    stateStr.append(", 暂无整体解冻基线, 无法估算节省");
+            }
+            if (activityDeferIoCnt || activityDeferNetCnt)
+                stateStr.appendFmt("\n因活动暂缓冻结 IO %d次 网络 %d次", activityDeferIoCnt, activityDeferNetCnt);
+            if (wakeupAvoidedCnt)
+                stateStr.appendFmt("\n无闹钟/任务 免定时解冻 %d次", wakeupAvoidedCnt);
+            if (preThawCnt)
+                stateStr.appendFmt("\n预解冻 %d次 命中 %d次 (%d%%), 提前完成的解冻处理 %.1fms", preThawCnt, preThawHitCnt,
+                    preThawHitCnt * 100 / preThawCnt, preThawHitHandleUs / 1000.0);
+
+            bool hasFreezeDelay = false;
+            for (const auto& appInfo : managedApp.appInfoMap) {
+                if (appInfo.uid < ManagedApp::UID_START || appInfo.freezeDelay <= 0) continue;
+                if (!hasFreezeDelay) {
+                    stateStr.append("\n自适应冻结延迟:");
+                    hasFreezeDelay = true;
+                }
+                int total = 0;
+                const int churn = getChurnPercent(appInfo, appInfo.freezeDelay, total);
+                stateStr.appendFmt("\n %s %d秒 (%d次切换 频繁%d%%)", appInfo.label.c_str(), appInfo.freezeDelay,
+                    total, churn);
+            }
+            if (quiescenceRefreezeCnt)
+                stateStr.appendFmt("\n静默后提前冻结 %d次, 缩短解冻 %d秒", quiescenceRefreezeCnt, quiescenceSavedSec);
+            if (wakeupWindowCnt) {
+                const int hours = max(1, static_cast<int>((time(nullptr) - wakeupWindowStartTime) / 3600));
+                stateStr.appendFmt("\n定时解冻 %d窗口 %d应用次, 平均 %.1f窗口/时", wakeupWindowCnt, wakeupBatchAppCnt,
+                    static_cast<double>(wakeupWindowCnt) / hours);
+            }
+            if (screenOffFreezeCnt)
+                stateStr.appendFmt("\n息屏冻结 %d应用次, 亮屏逐个解冻 %d应用次", screenOffFreezeCnt, screenOffThawCnt);
+            if (thawQueuedCnt)
+                stateStr.appendFmt("\n亮屏解冻排队 %d应用次, 其中成为顶层后优先解冻 %d次", thawQueuedCnt, thawTopFirstCnt);
+            if (fgServiceDeferCnt)
+                stateStr.appendFmt("\n因提供前台Binder服务暂缓冻结 %d次", fgServiceDeferCnt);
+
+            bool hasRestrictStat = false;
+            for (const auto& [uid, stat] : restrictStat) {
+                if (!managedApp.contains(uid)) continue;
+                const auto& appInfo = managedApp[uid];
+                int64_t curThrottledMs = -1, curMemStallMs = -1;
+                if (appInfo.isRestricted) getCurRestrictMs(appInfo, curThrottledMs, curMemStallMs);
+                const int64_t throttledMs = stat.throttledMs + max<int64_t>(curThrottledMs, 0);
+                const int64_t memStallMs = stat.memStallMs + max<int64_t>(curMemStallMs, 0);
+                if (throttledMs <= 0 && memStallMs <= 0) continue;
+                if (!hasRestrictStat) {
+                    stateStr.append("\n限制模式 CPU被限流 / 内存回收停顿:");
+                    hasRestrictStat = true;
+                }
+                stateStr.appendFmt("\n %s %.1f秒 / %.1f秒%s", appInfo.label.c_str(), throttledMs / 1000.0,
+                    memStallMs / 1000.0, appInfo.isRestricted ? " (限制中)" : "");
+            }
+            if (recycleCnt)
+                stateStr.appendFmt("\n冻结时内存回收 %d次 共释放 %.1fMiB (匿名 %.1fMiB)", recycleCnt,
+                    recycleFreedKiB / 1024.0, recycleAnonKiB / 1024.0);
+            if (psiReclaimCnt || psiKillCnt)
+                stateStr.appendFmt("\n内存压力 回收 %d应用次 %dMiB, 杀死 %d应用 %dMiB", psiReclaimCnt,
+                    psiReclaimKiB >> 10, psiKillCnt, psiKillKiB >> 10);
+            if (binderEventRecvCnt)
+                stateStr.appendFmt("\nBinder事件 接收%d 过滤%d 合并%d", binderEventRecvCnt.load(),
+                    binderEventFilterCnt.load(), binderEventCoalesceCnt.load());
+
             freezeit.log(stateStr.c_str(), stateStr.length);
         }
 
@@ -873,43 +1857,571 @@ public:
         else
             return;
 
+        const time_t now = time(nullptr);
+        set<int> topUids;
+        if (isThawPacing && !newShowOnApp.empty())
+            topUids = getTopAppUids();
+
         for (const int uid : newShowOnApp) {
+            recordDwell(uid, now);
+            recordUsage(uid, now);
+            wakeupCpuStart.erase(uid); // 用户打开 不再是定时解冻
+            if (managedApp[uid].freezeMode == FREEZE_MODE::MEMORY_LIMIT)
+                resetForegroundPeak(managedApp[uid]);
             // 如果在待冻结列表则只需移除
             if (pendingHandleList.erase(uid)) {  isupdate = true; continue; }
 
-            // 更新[打开时间]  并解冻
             auto& appInfo = managedApp[uid];
-            appInfo.startTimestamp = time(nullptr);
-
-            if (!appInfo.isPermissive)
-                setStandbyByLocalSocket(STANDBY::ACTIVE, appInfo);
-                
-            const int num = handleProcess(appInfo, false);
-            if (num > 0) freezeit.logFmt("☀️解冻 %s %d进程", appInfo.label.c_str(), num);
-            else freezeit.logFmt("😁启动 %s", appInfo.label.c_str());
-
-            appInfo.isFreeze = false;
+            if (isThawPacing && appInfo.isFreeze && !topUids.contains(uid)) { // 非顶层 排队解冻
+                enqueueThaw(THAW_PRIORITY::FOREGROUND, uid);
+                continue;
+            }
+            thawApp(appInfo);
         }
 
         for (const int uid : toBackgroundApp) { // 更新倒计时
             isupdate = true;
-            managedApp[uid].delayCnt = 0;
-            pendingHandleList[uid] = managedApp[uid].isTerminateMode() ?
-                settings.terminateTimeout : settings.freezeTimeout;
+            auto& appInfo = managedApp[uid];
+            appInfo.delayCnt = 0;
+            backgroundTime[uid] = now;
+            if (appInfo.freezeMode == FREEZE_MODE::MEMORY_LIMIT)
+                recordForegroundPeak(appInfo);
+            pendingHandleList[uid] = appInfo.isTerminateMode() ?
+                settings.terminateTimeout : updateFreezeDelay(appInfo);
         }
 
         if (isupdate)
             updatePendingByLocalSocket();
     }
 
+    // 更新[打开时间]  并解冻
+    void thawApp(appInfoStruct& appInfo) {
+        appInfo.startTimestamp = time(nullptr);
+
+        if (!appInfo.isPermissive)
+            setStandbyByLocalSocket(STANDBY::ACTIVE, appInfo);
+
+        if (appInfo.isRestricted) {
+            int64_t throttledMs, memStallMs;
+            getCurRestrictMs(appInfo, throttledMs, memStallMs);
+            handleProcess(appInfo, false);
+
+            stackString<256> tmp;
+            tmp.appendFmt("🐇解除限制 %s", appInfo.label.c_str());
+            if (throttledMs > 0) tmp.appendFmt(" 后台期间被限流 %lldms", (long long)throttledMs);
+            if (memStallMs > 0) tmp.appendFmt(" 内存回收停顿 %lldms", (long long)memStallMs);
+            freezeit.log(tmp.c_str(), tmp.length);
+            appInfo.isFreeze = false;
+            return;
+        }
+
+        const int num = handleProcess(appInfo, false);
+        if (num > 0) freezeit.logFmt("☀️解冻 %s %d进程", appInfo.label.c_str(), num);
+        else freezeit.logFmt("😁启动 %s", appInfo.label.c_str());
+
+        appInfo.isFreeze = false;
+    }
+
+    void enqueueThaw(const THAW_PRIORITY priority, const int uid) {
+        lock_guard<mutex> lock(thawQueueMutex);
+        for (const auto& item : thawQueue)
+            if (item.second == uid) return;
+
+        // 按优先级插入, 同优先级先到先解冻
+        auto it = thawQueue.begin();
+        while (it != thawQueue.end() && it->first <= priority) it++;
+        thawQueue.insert(it, { priority, uid });
+        thawQueuedCnt++;
+    }
+
+    // 退出息屏待机时调用, 之后非顶层应用的解冻都经过队列
+    void startThawPacing() {
+        lock_guard<mutex> lock(thawQueueMutex);
+        thawQueue.clear();
+        thawQueueStartMs = getSteadyMs();
+        isThawPacing = true;
+    }
+
+    // 进入息屏待机: 只扫描一次/proc 批量冻结所有"息屏冻结"应用
+    void freezeScreenOffApps() {
+        START_TIME_COUNT;
+
+        set<int> uidSet;
+        for (const auto& appInfo : managedApp.appInfoMap) {
+            if (appInfo.uid < ManagedApp::UID_START || !appInfo.isScreenOffMode()) continue;
+            if (appInfo.isFreeze || appInfo.isAudioPlaying) continue;
+            uidSet.insert(appInfo.uid);
+        }
+
+        {
+            lock_guard<mutex> lock(thawQueueMutex);
+            thawQueue.clear(); // 亮屏后尚未解冻的应用继续保持冻结
+            isThawPacing = false;
+        }
+        if (uidSet.empty()) return;
+
+        int appCnt = 0, pidCnt = 0;
+        stackString<1024> tmp("❄️息屏冻结");
+        for (auto& [uid, pids] : getRunningPids(uidSet)) {
+            auto& appInfo = managedApp[uid];
+            appInfo.pids = std::move(pids);
+
+            const int num = handleProcess(appInfo, true, false);
+            if (num < 0) { // Binder正在传输, 交给待冻结列队延迟处理
+                pendingHandleList[uid] = 5;
+                continue;
+            }
+
+            appInfo.isFreeze = true;
+            appCnt++;
+            pidCnt += num;
+            tmp.append(' ').append(appInfo.label.c_str());
+        }
+
+        if (appCnt) {
+            screenOffFreezeCnt += appCnt;
+            tmp.appendFmt(" | 共%d应用 %d进程", appCnt, pidCnt);
+            freezeit.log(tmp.c_str(), tmp.length);
+        }
+
+        END_TIME_COUNT;
+    }
+
+    // 退出息屏待机: 已冻结的"息屏冻结"应用加入解冻队列
+    void queueScreenOffThaw() {
+        for (const auto& appInfo : managedApp.appInfoMap) {
+            if (appInfo.uid < ManagedApp::UID_START || !appInfo.isScreenOffMode() || !appInfo.isFreeze) continue;
+            enqueueThaw(THAW_PRIORITY::SCREENOFF, appInfo.uid);
+        }
+    }
+
+    // 队列中的应用是否仍需解冻
+    bool isThawStillNeeded(const THAW_PRIORITY priority, const int uid) {
+        const auto& appInfo = managedApp[uid];
+        if (!appInfo.isFreeze) return false;
+        if (priority == THAW_PRIORITY::SCREENOFF) return appInfo.isScreenOffMode();
+        return lastForegroundApp.contains(uid) && !pendingHandleList.contains(uid);
+    }
+
+    // 解冻队列 call once per 200ms
+    // 已成为顶层的应用立即解冻; 其余在延迟后按优先级每次解冻若干个, 用户操作中只解冻一个
+    void processThawQueue() {
+        lock_guard<mutex> lock(thawQueueMutex);
+        if (thawQueue.empty()) {
+            isThawPacing = false;
+            return;
+        }
+
+        const auto topUids = getTopAppUids();
+        erase_if(thawQueue, [this, &topUids](const auto& item) {
+            if (!topUids.contains(item.second)) return false;
+            if (isThawStillNeeded(item.first, item.second)) {
+                thawApp(managedApp[item.second]);
+                thawTopFirstCnt++;
+            }
+            return true;
+        });
+
+        if (getSteadyMs() - thawQueueStartMs < THAW_QUEUE_DELAY_MS) return;
+
+        int remain = isUserActive() ? 1 : settings.getThawBatchSize();
+        while (remain > 0 && !thawQueue.empty()) {
+            const auto [priority, uid] = thawQueue.front();
+            thawQueue.erase(thawQueue.begin());
+            if (!isThawStillNeeded(priority, uid)) continue;
+
+            auto& appInfo = managedApp[uid];
+            if (priority == THAW_PRIORITY::SCREENOFF) {
+                const int num = handleProcess(appInfo, false);
+                appInfo.isFreeze = false;
+                screenOffThawCnt++;
+                if (num > 0) freezeit.logFmt("☀️亮屏解冻 %s %d进程", appInfo.label.c_str(), num);
+            }
+            else thawApp(appInfo);
+            remain--;
+        }
+    }
+
+    void recordUsage(const int uid, const time_t now) {
+        auto& usage = appUsage[uid];
+        usage.frequency = usage.frequency * 0.95f + 1;
+        usage.lastUseTime = now;
+
+        lock_guard<mutex> lock(preThawMutex);
+        auto it = preThawList.find(uid);
+        if (it != preThawList.end()) {
+            if (now - it->second.first <= PRETHAW_WINDOW_SEC) {
+                preThawHitCnt++;
+                preThawHitHandleUs += it->second.second;
+            }
+            preThawList.erase(it);
+        }
+    }
+
+    // 顶层 cpuset 中进程的UID
+    set<int> getTopAppUids() {
+        set<int> uids;
+        char buf[1024 * 4];
+        if (Utils::readString(cpusetEventPathA13, buf, sizeof(buf) - 1) == 0 &&
+            Utils::readString(cpusetEventPathA12, buf, sizeof(buf) - 1) == 0)
+            return uids;
+
+        char* ptr = buf;
+        while (*ptr) {
+            char* endPtr;
+            const int pid = static_cast<int>(strtol(ptr, &endPtr, 10));
+            if (endPtr == ptr) break;
+            ptr = endPtr;
+
+            char path[32];
+            FastSnprintf(path, sizeof(path), "/proc/%d", pid);
+            struct stat statBuf;
+            if (!stat(path, &statBuf))
+                uids.insert(statBuf.st_uid);
+        }
+        return uids;
+    }
+
+    // 顶层是否为桌面 (最近任务界面一般也属于桌面进程)
+    bool checkHomeTop() {
+        const int homeUid = managedApp.getHomeUid();
+        return homeUid >= 0 && getTopAppUids().contains(homeUid);
+    }
+
+    // 按 频率+近期使用 排序, 预解冻前 PRETHAW_APP_CNT 个已冻结的应用
+    void preThawLikelyApps() {
+        const time_t now = time(nullptr);
+        vector<pair<float, int>> rank;
+        for (const auto& [uid, usage] : appUsage) {
+            if (!managedApp.contains(uid) || pendingHandleList.contains(uid)) continue;
+            const auto& appInfo = managedApp[uid];
+            if (!appInfo.isFreeze || appInfo.isWhitelist() || appInfo.isTerminateMode()) continue;
+
+            const float recency = 20.0f / (1 + (now - usage.lastUseTime) / 60.0f);
+            rank.emplace_back(usage.frequency + recency, uid);
+        }
+        if (rank.empty()) return;
+
+        const size_t cnt = min(rank.size(), static_cast<size_t>(PRETHAW_APP_CNT));
+        std::partial_sort(rank.begin(), rank.begin() + cnt, rank.end(),
+            [](const auto& a, const auto& b) { return a.first > b.first; });
+
+        stackString<256> tmp("🔮预解冻");
+        for (size_t i = 0; i < cnt; i++) {
+            const int uid = rank[i].second;
+
+            // 与临时解冻相同的流程(恢复待机分组/运行计时), 未被打开则窗口结束后重新冻结, 不做静默检测
+            const auto startTime = std::chrono::steady_clock::now();
+            unFreezerTemporary(uid, PRETHAW_WINDOW_SEC, false);
+            const int handleUs = static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - startTime).count());
+
+            {
+                lock_guard<mutex> lock(preThawMutex);
+                preThawList[uid] = { now, handleUs };
+            }
+            preThawCnt++;
+            tmp.append(' ').append(managedApp[uid].label.c_str());
+        }
+        freezeit.debug(tmp.c_str());
+    }
+
+    // 顶层应用切换后由解冻线程调用, 只做检测
+    void checkPreThaw() {
+        const bool isHome = checkHomeTop();
+        if (isHome && !isHomeTop && !doze.isScreenOffStandby)
+            isPreThawRequested = true;
+        isHomeTop = isHome;
+
+        const time_t now = time(nullptr);
+        lock_guard<mutex> lock(preThawMutex);
+        erase_if(preThawList, [now](const auto& item) { return now - item.second.first > PRETHAW_WINDOW_SEC; });
+    }
+
+    void recordDwell(const int uid, const time_t now) {
+        auto it = backgroundTime.find(uid);
+        if (it == backgroundTime.end()) return;
+
+        const int dwellSec = static_cast<int>(now - it->second);
+        backgroundTime.erase(it);
+        if (!managedApp.contains(uid) || dwellSec < 0) return;
+
+        auto& hist = managedApp[uid].dwellHist;
+        int idx = 0;
+        while (idx < appInfoStruct::DWELL_BUCKET_CNT - 1 && dwellSec >= dwellBucketEdge[idx]) idx++;
+        hist[idx]++;
+
+        int total = 0;
+        for (const auto cnt : hist) total += cnt;
+        if (total > DWELL_DECAY_TOTAL)
+            for (auto& cnt : hist) cnt >>= 1;
+        isDwellChanged = true;
+    }
+
+    // 延迟 delay 秒冻结时, 冻结后又在 FREEZE_DELAY_MAX 内回到前台的比例 (%)
+    static int getChurnPercent(const appInfoStruct& appInfo, const int delay, int& total) {
+        int churn = 0;
+        total = 0;
+        for (int i = 0; i < appInfoStruct::DWELL_BUCKET_CNT; i++) {
+            total += appInfo.dwellHist[i];
+            const int lower = i == 0 ? 0 : dwellBucketEdge[i - 1];
+            if (lower >= delay && i < appInfoStruct::DWELL_BUCKET_CNT - 1)
+                churn += appInfo.dwellHist[i];
+        }
+        return total ? churn * 100 / total : 0;
+    }
+
+    // 返回本次冻结延迟(秒), 范围 全局超时冻结 ~ FREEZE_DELAY_MAX
+    int updateFreezeDelay(appInfoStruct& appInfo) {
+        const int minDelay = settings.freezeTimeout;
+        int total = 0;
+        getChurnPercent(appInfo, minDelay, total);
+        if (total < DWELL_MIN_SAMPLE) {
+            appInfo.freezeDelay = 0;
+            return minDelay;
+        }
+
+        int delay = minDelay;
+        for (const int edge : dwellBucketEdge) {
+            if (getChurnPercent(appInfo, delay, total) <= FREEZE_CHURN_PERCENT) break;
+            if (edge > delay) delay = edge;
+        }
+        delay = min(delay, FREEZE_DELAY_MAX);
+
+        if (delay != max(appInfo.freezeDelay, minDelay))
+            freezeit.debugFmt("%s 冻结延迟 %d秒 (频繁切换 %d%%)", appInfo.label.c_str(), delay,
+                getChurnPercent(appInfo, delay, total));
+        appInfo.freezeDelay = delay > minDelay ? delay : 0;
+        return delay;
+    }
+
+    static int getPidUid(const int pid, unordered_map<int, int>& cache) {
+        auto it = cache.find(pid);
+        if (it != cache.end()) return it->second;
+
+        char path[32];
+        FastSnprintf(path, sizeof(path), "/proc/%d", pid);
+        struct stat statBuf;
+        const int uid = stat(path, &statBuf) ? -1 : (int)statBuf.st_uid;
+        cache[pid] = uid;
+        return uid;
+    }
+
+    // 解析 binder transactions, 找出正在为前台应用提供服务的应用(含间接调用)
+    // "    outgoing transaction 123: 0000000000000000 from 1234:1240 to 5678:5690 code 3 flags 10 ..."
+    void updateBinderDependency() {
+        fgServiceUids.clear();
+
+        int fd = open(binderfsTransactionsPath, O_RDONLY);
+        if (fd < 0) fd = open(debugfsTransactionsPath, O_RDONLY);
+        if (fd < 0) return;
+
+        unordered_map<int, int> pidUidCache;
+        unordered_map<int, unordered_set<int>> edges; // { 调用方uid, 服务方uid }
+
+        char buff[16 * 1024 + 1];
+        size_t remainLen = 0;
+        ssize_t readLen;
+        while ((readLen = read(fd, buff + remainLen, sizeof(buff) - 1 - remainLen)) > 0) {
+            const size_t len = remainLen + readLen;
+            buff[len] = 0;
+
+            char* lineStart = buff;
+            char* lineEnd;
+            while ((lineEnd = strchr(lineStart, '\n')) != nullptr) {
+                *lineEnd = 0;
+
+                const char* ptr = strstr(lineStart, "transaction ");
+                if (ptr && (ptr = strstr(ptr, " from ")) != nullptr) {
+                    const int fromPid = atoi(ptr + 6);
+                    ptr = strstr(ptr, " to ");
+                    const int toPid = ptr ? atoi(ptr + 4) : 0;
+                    if (fromPid > 0 && toPid > 0 && fromPid != toPid) {
+                        const int fromUid = getPidUid(fromPid, pidUidCache);
+                        const int toUid = getPidUid(toPid, pidUidCache);
+                        if (fromUid >= 0 && toUid >= ManagedApp::UID_START && fromUid != toUid)
+                            edges[fromUid].insert(toUid);
+                    }
+                }
+                lineStart = lineEnd + 1;
+            }
+
+            // 不完整的行留到下次读取
+            remainLen = len - (lineStart - buff);
+            if (remainLen == sizeof(buff) - 1) remainLen = 0; // 超长行丢弃
+            memmove(buff, lineStart, remainLen);
+        }
+        close(fd);
+
+        if (edges.empty()) return;
+
+        vector<int> queue(curForegroundApp.begin(), curForegroundApp.end());
+        while (!queue.empty()) {
+            const int uid = queue.back();
+            queue.pop_back();
+
+            auto it = edges.find(uid);
+            if (it == edges.end()) continue;
+            for (const int serviceUid : it->second) {
+                if (curForegroundApp.contains(serviceUid) || !fgServiceUids.insert(serviceUid).second) continue;
+                queue.emplace_back(serviceUid);
+            }
+        }
+    }
+
+    bool isServingForeground(const int uid) {
+        const time_t now = time(nullptr);
+        if (now != binderGraphTime) { // 每秒最多刷新一次
+            binderGraphTime = now;
+            updateBinderDependency();
+        }
+        return fgServiceUids.contains(uid);
+    }
+
+    // 采样冻结中进程的Binder状态, 标志在进程冻结期间保持, 只统计新出现的标志
+    void sampleBinderStats() {
+        if (!settings.enableBinderFreezer || bs.fd <= 0) return;
+
+        lock_guard<mutex> lock(binderStatMutex);
+
+        unordered_map<int, uint32_t> curFlags;
+        for (const auto& appInfo : managedApp.appInfoMap) {
+            if (appInfo.uid < ManagedApp::UID_START || !appInfo.isFreeze || !appInfo.isFreezeMode()) continue;
+
+            bool hasSample = false;
+            for (const int pid : appInfo.pids) {
+                binder_frozen_status_info statusInfo = { (uint32_t)pid, 0, 0 };
+                if (ioctl(bs.fd, BINDER_GET_FROZEN_INFO, &statusInfo) < 0) continue;
+
+                // bit0:sync_recv bit1:txns_pending bit2:async_recv
+                const uint32_t flags = (statusInfo.sync_recv & 0b11) | ((statusInfo.async_recv & 1) << 2);
+                const auto lastIt = binderLastFlags.find(pid);
+                const uint32_t newFlags = flags & ~(lastIt == binderLastFlags.end() ? 0 : lastIt->second);
+                curFlags[pid] = flags;
+
+                auto& stat = binderStats[appInfo.uid];
+                if (newFlags & 0b001) stat.syncRecvCnt++;
+                if (newFlags & 0b100) stat.asyncRecvCnt++;
+                if (flags & 0b010) stat.pendingCnt++;
+                hasSample = true;
+            }
+            if (hasSample)
+                binderStats[appInfo.uid].sampleCnt++;
+        }
+        binderLastFlags = std::move(curFlags);
+    }
+
+    // 返回写入的int个数 [uid sampleCnt syncRecv asyncRecv pending]... 按冻结期间收到的同步+异步传输次数之和降序
+    int getBinderStats(int* ptr, const int maxIntCnt) {
+        lock_guard<mutex> lock(binderStatMutex);
+
+        vector<pair<int, binderStatStruct>> statSort(binderStats.begin(), binderStats.end());
+        std::sort(statSort.begin(), statSort.end(), [](const auto& a, const auto& b) {
+            return a.second.asyncRecvCnt + a.second.syncRecvCnt > b.second.asyncRecvCnt + b.second.syncRecvCnt;
+        });
+
+        int intCnt = 0;
+        for (const auto& [uid, stat] : statSort) {
+            if (intCnt + 5 > maxIntCnt) break;
+            ptr[intCnt++] = uid;
+            ptr[intCnt++] = stat.sampleCnt;
+            ptr[intCnt++] = stat.syncRecvCnt;
+            ptr[intCnt++] = stat.asyncRecvCnt;
+            ptr[intCnt++] = stat.pendingCnt;
+        }
+        return intCnt;
+    }
+
+    // /proc/uid_io/stats: uid fg_rchar fg_wchar fg_rbytes fg_wbytes bg_rchar bg_wchar bg_rbytes bg_wbytes ...
+    // rchar/wchar 含网络收发, 取前后台读写总和
+    static uint64_t getUidIoBytes(const int uid) {
+        char uidStr[16];
+        const size_t uidLen = FastSnprintf(uidStr, sizeof(uidStr), "%d ", uid);
+
+        uint64_t bytes = 0;
+        Utils::scanLines("/proc/uid_io/stats", [&](const char* line, const size_t len) {
+            if (len <= uidLen || memcmp(line, uidStr, uidLen)) return true;
+
+            const char* const end = line + len;
+            const char* ptr = line + uidLen;
+            for (int i = 0; i < 6; i++) {
+                ptr = Utils::skipFields(ptr, end, 0);
+                if (i != 2 && i != 3) // 跳过 fg_rbytes fg_wbytes, 与 rchar/wchar 重复
+                    bytes += strtoull(ptr, nullptr, 10);
+                ptr = Utils::skipFields(ptr, end, 1);
+            }
+            return false;
+        });
+        return bytes;
+    }
+
+    // /proc/net/tcp{,6}: sl local rem st tx_queue:rx_queue tr:when retrnsmt uid ...
+    static uint64_t getUidTcpQueueBytes(const int uid) {
+        uint64_t bytes = 0;
+        for (const char* path : { "/proc/net/tcp", "/proc/net/tcp6" }) {
+            Utils::scanLines(path, [&](const char* line, const size_t len) {
+                const char* const end = line + len;
+                const char* ptr = Utils::skipFields(line, end, 4);
+                if (ptr >= end) return true;
+
+                char* endPtr;
+                const uint64_t txQueue = strtoull(ptr, &endPtr, 16);
+                if (*endPtr != ':') return true; // 表头
+                const uint64_t rxQueue = strtoull(endPtr + 1, nullptr, 16);
+
+                ptr = Utils::skipFields(ptr, end, 3);
+                if (ptr < end && (int)strtol(ptr, nullptr, 10) == uid)
+                    bytes += txQueue + rxQueue;
+                return true;
+            });
+        }
+        return bytes;
+    }
+
+    // 应用是否仍有明显的IO/网络活动, 返回原因, 无活动返回 nullptr
+    const char* checkAppActivity(const int uid) {
+        static char reason[64];
+
+        const uint64_t ioBytes = getUidIoBytes(uid);
+        const time_t now = time(nullptr);
+        auto baseIt = ioBaseline.find(uid);
+        if (baseIt == ioBaseline.end()) {
+            ioBaseline[uid] = { ioBytes, now }; // 无基准, 无法判断IO速率, 仅检查网络
+        }
+        else {
+            const time_t elapsed = now - baseIt->second.second;
+            const uint64_t delta = ioBytes > baseIt->second.first ? ioBytes - baseIt->second.first : 0;
+            baseIt->second = { ioBytes, now };
+            if (elapsed > 0 && delta / elapsed >= ACTIVITY_IO_BYTES_PER_SEC) {
+                activityDeferIoCnt++;
+                FastSnprintf(reason, sizeof(reason), "IO活跃 %dKiB/s", (int)(delta / elapsed / 1024));
+                return reason;
+            }
+        }
+
+        const uint64_t queueBytes = getUidTcpQueueBytes(uid);
+        if (queueBytes >= ACTIVITY_TCP_QUEUE_BYTES) {
+            activityDeferNetCnt++;
+            FastSnprintf(reason, sizeof(reason), "网络传输中 队列%dKiB", (int)(queueBytes / 1024));
+            return reason;
+        }
+        return nullptr;
+    }
+
     // 处理待冻结列队 call once per 1sec
     void processPendingApp() {
         bool isupdate = false;
 
+        // 未冻结就离开待冻结列表的(回到前台/切换白名单/被移除等) 清除IO基准及暂缓时长, 下次进入后台重新记录
+        erase_if(ioBaseline, [this](const auto& item) { return !pendingHandleList.contains(item.first); });
+        erase_if(activityDeferSec, [this](const auto& item) { return !pendingHandleList.contains(item.first); });
+
         auto it = pendingHandleList.begin();
         while (it != pendingHandleList.end()) {
             auto& remainSec = it->second;
             if (--remainSec > 0) {//每次轮询减一
+                if (remainSec == 2 && !ioBaseline.contains(it->first)) // 冻结前2秒 记录IO基准
+                    ioBaseline[it->first] = { getUidIoBytes(it->first), time(nullptr) };
                 it++;
                 continue;
             }
@@ -923,18 +2435,85 @@ public:
                 continue;
             }
 
+            // 息屏冻结的应用在待机期间被临时解冻, 到期后需重新冻结
+            const bool isScreenOffStandby = appInfo.isScreenOffMode() && doze.isScreenOffStandby;
+            if (isScreenOffStandby) {
+                curForegroundApp.erase(uid);
+                lastForegroundApp.erase(uid);
+            }
+
             if (curForegroundApp.contains(uid)) { // 前台应用不应该在待冻结列表中
                 it = pendingHandleList.erase(it);
                 isupdate = true;
                 continue;
             }
 
-            if (appInfo.isWhitelist()) { // 刚切换成白名单的
+            if (appInfo.isWhitelist() && !isScreenOffStandby) { // 刚切换成白名单的
+                it = pendingHandleList.erase(it);
+                continue;
+            }
+
+            if (appInfo.isRestrictMode()) { // 限制模式: 不冻结, 也无需定时解冻
+                if (!appInfo.isRestricted) {
+                    const int num = handleProcess(appInfo, true);
+                    freezeit.logFmt("🐢限制 %s %d进程", appInfo.label.c_str(), num);
+                }
                 it = pendingHandleList.erase(it);
+                isupdate = true;
                 continue;
             }
 
-            MemoryRecycle(appInfo); 
+            if (isServingForeground(uid)) { // 前台应用正在通过Binder调用该应用, 冻结会导致前台卡住
+                constexpr int FG_SERVICE_DEFER_MAX = 300;
+                auto& deferSec = fgServiceDeferSec[uid];
+                if (deferSec < FG_SERVICE_DEFER_MAX) {
+                    if (deferSec == 0)
+                        freezeit.logFmt("%s 正在为前台应用提供Binder服务, 暂缓冻结", appInfo.label.c_str());
+                    deferSec += 2;
+                    remainSec = 2;
+                    fgServiceDeferCnt++;
+                    it++;
+                    continue;
+                }
+                freezeit.logFmt("%s 为前台应用提供Binder服务已超过%d分钟, 不再等待", appInfo.label.c_str(),
+                    FG_SERVICE_DEFER_MAX / 60);
+            }
+            fgServiceDeferSec.erase(uid);
+
+            if (!appInfo.isTerminateMode()) {
+                const char* reason = checkAppActivity(uid);
+                if (reason != nullptr) {
+                    auto& deferSec = activityDeferSec[uid];
+                    if (deferSec < ACTIVITY_DEFER_MAX) {
+                        if (deferSec == 0 || freezeit.isDebugOn())
+                            freezeit.logFmt("%s %s, 暂缓冻结", appInfo.label.c_str(), reason);
+                        remainSec = ACTIVITY_DEFER_SEC;
+                        deferSec += ACTIVITY_DEFER_SEC;
+                        it++;
+                        continue;
+                    }
+                    freezeit.logFmt("%s 活动已持续%d分钟, 不再等待", appInfo.label.c_str(), ACTIVITY_DEFER_MAX / 60);
+                }
+            }
+            activityDeferSec.erase(uid);
+            ioBaseline.erase(uid);
+
+            if (isUserActive()) deferredReclaimUids.insert(uid);
+            else MemoryRecycle(appInfo); 
+
+            auto thawIt = fullThawStart.find(uid);
+            if (thawIt != fullThawStart.end()) {
+                const int thawSec = static_cast<int>(time(nullptr) - thawIt->second.second);
+                const int cpuTimeMs = getAppCpuTimeMs(appInfo) - thawIt->second.first;
+                if (thawSec > 0 && cpuTimeMs >= 0) {
+                    auto& cost = fullThawCost[uid];
+                    cost.cpuTimeMs += cpuTimeMs;
+                    cost.thawSec += thawSec;
+                }
+                fullThawStart.erase(thawIt);
+            }
+
+            updateWakeupInterval(appInfo);
 
             int num = handleProcess(appInfo, true);
             if (num < 0) {
@@ -994,14 +2573,15 @@ public:
 
 
     void MemoryRecycle(const appInfoStruct& appInfo) {
-        if (!settings.enableMemoryReclaim) return;
-        char path [32];
-        for (const int pid : appInfo.pids) {
-            // 1:file 2:anon 3:all
-            FastSnprintf(path, sizeof(path), "/proc/%d/reclaim", pid);
-            Utils::writeString(path, "file", 4);
-        }
-        if (settings.enableDebug) freezeit.logFmt("内存回收: %s ", appInfo.label.c_str());
+        if (!settings.enableMemoryReclaim || appInfo.pids.empty()) return;
+
+        const auto result = reclaimAppMemory(appInfo, appInfo.reclaimType);
+        recycleCnt++;
+        recycleFreedKiB += result.freedKiB;
+        recycleAnonKiB += result.anonKiB;
+        freezeit.logFmt("♻️内存回收 %s 释放 %.1fMiB (匿名 %.1fMiB 文件 %.1fMiB) [%s]", appInfo.label.c_str(),
+            result.freedKiB / 1024.0, result.anonKiB / 1024.0, (result.freedKiB - result.anonKiB) / 1024.0,
+            result.backend);
     }
 
 
@@ -1039,63 +2619,43 @@ public:
         return;
     }
 
-    void getAudioByLocalSocket() {
+    // 同步播放音频的应用, 停止播放的加入待冻结列队 call once per 1sec
+    void updateAudioApp() {
         constexpr int waitSeconds = 6;
-        while (true) {
-            if (!systemTools.isAudioPlaying) { sleep(1); continue; }
-            int buff[64] = {};  
 
-            int recvLen = Utils::localSocketRequest(XPOSED_CMD::GET_AUDIO, nullptr, 0, buff, 
-                sizeof(buff));
+        const uint32_t version = systemTools.audioUidVersion;
+        if (version == audioUidVersion) return;
+        audioUidVersion = version;
 
-            if (recvLen <= 0) {
-                freezeit.logFmt("%s() 工作异常, 请确认LSPosed中Frozen是否已经勾选系统框架", __FUNCTION__);
-                return;
-            }
-            else if (recvLen < 4) {
-                freezeit.logFmt("%s() 返回数据异常 recvLen[%d]", __FUNCTION__, recvLen);
-                if (recvLen > 0 && recvLen < 64 * 4)
-                    freezeit.logFmt("DumpHex: %s", Utils::bin2Hex(buff, recvLen).c_str());
-                return;
-            }
-
-            const int uidCount = (recvLen / 4) - 1; 
+        currentAudioApp.clear();
+        for (const int uid : systemTools.getAudioUids()) {
+            if (!managedApp.contains(uid))
+                continue;
 
-            currentAudioApp.clear();
+            auto& appInfo = managedApp[uid];
+            if (appInfo.isWhitelist() || !appInfo.isPermissive)
+                continue;
 
-            for (int i = 0; i < uidCount; ++i) {
-                int uid = buff[i];
+            if (appInfo.package == "com.ss.android.ugc.aweme"
+                || appInfo.package == "tv.danmaku.bili"
+                || appInfo.package == "com.ss.android.ugc.aweme.lite") continue;
 
-                if (!managedApp.contains(uid))
-                    continue;
-                
-                auto& appInfo = managedApp[uid];
-                if (appInfo.isWhitelist()) 
-                    continue;
-                
-                if (appInfo.isPermissive && !lastAudioApp.contains(uid) && !appInfo.isAudioPlaying) {
-                    if (appInfo.package == "com.ss.android.ugc.aweme" 
-                        || appInfo.package == "tv.danmaku.bili"
-                        || appInfo.package == "com.ss.android.ugc.aweme.lite") continue;
-                    appInfo.isAudioPlaying = true;
-                    currentAudioApp.insert(uid);
-                }
-            }
+            if (!appInfo.isAudioPlaying)
+                freezeit.debugFmt("🎵%s 正在播放音频", appInfo.label.c_str());
+            appInfo.isAudioPlaying = true;
+            currentAudioApp.insert(uid);
+        }
 
-            for (const int lastUid : lastAudioApp) {
-                if (!currentAudioApp.contains(lastUid)) {
-                    managedApp[lastUid].isAudioPlaying = false;
+        for (const int lastUid : lastAudioApp) {
+            if (!currentAudioApp.contains(lastUid)) {
+                managedApp[lastUid].isAudioPlaying = false;
+                if (!curForegroundApp.contains(lastUid))
                     pendingHandleList[lastUid] = waitSeconds;
-                }
             }
-
-            lastAudioApp = std::move(currentAudioApp);
-            
-            Utils::sleep_ms(1000); 
         }
-    }
-
 
+        lastAudioApp = currentAudioApp;
+    }
 
     void handlePendingIntent() {
         sleep(3); 
@@ -1126,41 +2686,295 @@ public:
                 if (!managedApp.contains(uid))
                     return;
 
-                auto& appInfo = managedApp[uid];
-                if (appInfo.isFreeze && !pendingHandleList.contains(uid)) {
-                    freezeit.logFmt("后台意图:[%s],将进行临时解冻", appInfo.label.c_str());
-                    unFreezerTemporary(uid, 3);
-                }
-            }
-            Utils::sleep_ms(1500);
+                auto& appInfo = managedApp[uid];
+                if (appInfo.isFreeze && !pendingHandleList.contains(uid)) {
+                    freezeit.logFmt("后台意图:[%s],将进行临时解冻", appInfo.label.c_str());
+                    unFreezerTemporary(uid, TEMP_THAW_CEILING_SEC);
+                }
+            }
+            Utils::sleep_ms(1500);
+        }
+    }
+
+
+    // 在 [目标时刻 ± 容差] 内已有批次则并入最近的批次, 否则新建批次  容差为延迟的1/4
+    void insertTimeline(appInfoStruct& appInfo, const int delaySec) {
+        const uint32_t target = timelineIdx + max(delaySec, 1);
+        const uint32_t window = std::clamp(delaySec / 4, WAKEUP_BATCH_WINDOW_MIN, WAKEUP_BATCH_WINDOW_MAX);
+
+        lock_guard<mutex> lock(timelineMutex);
+        uint32_t batchIdx = target, minDistance = window + 1;
+        auto it = unfrozenTimeline.lower_bound(target);
+        if (it != unfrozenTimeline.end() && it->first - target < minDistance) {
+            batchIdx = it->first;
+            minDistance = it->first - target;
+        }
+        if (it != unfrozenTimeline.begin()) {
+            const uint32_t prevIdx = std::prev(it)->first;
+            if (prevIdx > timelineIdx && target - prevIdx < minDistance)
+                batchIdx = prevIdx;
+        }
+
+        unfrozenTimeline[batchIdx].emplace_back(appInfo.uid);
+        appInfo.timelineUnfrozenIdx = static_cast<int>(batchIdx);
+    }
+
+    void removeTimeline(appInfoStruct& appInfo) {
+        if (appInfo.timelineUnfrozenIdx < 0) return;
+
+        lock_guard<mutex> lock(timelineMutex);
+        auto it = unfrozenTimeline.find(static_cast<uint32_t>(appInfo.timelineUnfrozenIdx));
+        if (it != unfrozenTimeline.end()) {
+            std::erase(it->second, appInfo.uid);
+            if (it->second.empty())
+                unfrozenTimeline.erase(it);
+        }
+        appInfo.timelineUnfrozenIdx = -1;
+    }
+
+    // 待机暂停定时解冻时, 统计被推迟的批次
+    int getTimelineBatchSize(const uint32_t idx) {
+        lock_guard<mutex> lock(timelineMutex);
+        auto it = unfrozenTimeline.find(idx);
+        return it == unfrozenTimeline.end() ? 0 : static_cast<int>(it->second.size());
+    }
+
+    // 解析 TimeUtils.formatDuration 格式 "+1d2h3m4s5ms" "-12s300ms" "0", 结果为秒
+    static bool parseDuration(const char* ptr, int& sec) {
+        if (*ptr == '0') { sec = 0; return true; }
+        if (*ptr != '+' && *ptr != '-') return false;
+
+        const bool isNegative = *ptr++ == '-';
+        int64_t ms = 0;
+        bool hasUnit = false;
+        while ('0' <= *ptr && *ptr <= '9') {
+            int64_t num = 0;
+            while ('0' <= *ptr && *ptr <= '9')
+                num = num * 10 + (*ptr++ - '0');
+
+            switch (*ptr++) {
+            case 'd': ms += num * 86400000; break;
+            case 'h': ms += num * 3600000; break;
+            case 's': ms += num * 1000; break;
+            case 'm':
+                if (*ptr == 's') { ms += num; ptr++; }
+                else ms += num * 60000;
+                break;
+            default:
+                return false;
+            }
+            hasUnit = true;
+        }
+        if (!hasUnit) return false;
+
+        sec = static_cast<int>((isNegative ? -ms : ms) / 1000);
+        return true;
+    }
+
+    void setWakeupDeadline(const int uid, const time_t deadline) {
+        if (!managedApp.contains(uid)) return;
+        auto it = wakeupDeadline.find(uid);
+        if (it == wakeupDeadline.end()) wakeupDeadline[uid] = deadline;
+        else if (deadline < it->second) it->second = deadline;
+    }
+
+    // 原地逐行扫描, 不复制内容
+    // "    RTC_WAKEUP #3: Alarm{5a7e1c2 type 0 origWhen 1700000000000 com.tencent.mm}"
+    // "      whenElapsed=+12m3s45ms maxWhenElapsed=+15m3s45ms"
+    int parseAlarmDump(char* buf, const time_t now) {
+        int alarmCnt = 0, uid = -1;
+        for (char* line = buf; line && *line;) {
+            char* lineEnd = strchr(line, '\n');
+            if (lineEnd) *lineEnd = 0;
+
+            const char* ptr = strstr(line, "Alarm{");
+            if (ptr) {
+                uid = -1;
+                const char* pkgEnd = strchr(ptr, '}');
+                if (pkgEnd) {
+                    const char* pkgStart = pkgEnd;
+                    while (pkgStart > ptr && pkgStart[-1] != ' ') pkgStart--;
+                    const string package(pkgStart, pkgEnd - pkgStart);
+                    if (managedApp.contains(package))
+                        uid = managedApp.getUid(package);
+                    alarmCnt++;
+                }
+            }
+            else if (uid >= 0 && (ptr = strstr(line, "whenElapsed=")) != nullptr) {
+                int sec;
+                if (parseDuration(ptr + 12, sec))
+                    setWakeupDeadline(uid, now + sec);
+                uid = -1;
+            }
+            line = lineEnd ? lineEnd + 1 : nullptr;
+        }
+        return alarmCnt;
+    }
+
+    // "  JOB #u0a123/45: 1a2b3c com.tencent.mm/.SyncService"
+    // "    Run time: earliest=+12m3s, latest=+1h4m"  ("none" 表示无时间约束, 负值表示已过)
+    int parseJobDump(char* buf, const time_t now) {
+        int jobCnt = 0, uid = -1;
+        for (char* line = buf; line && *line;) {
+            char* lineEnd = strchr(line, '\n');
+            if (lineEnd) *lineEnd = 0;
+
+            const char* ptr = strstr(line, "JOB #");
+            if (ptr) {
+                ptr += 5;
+                uid = -1;
+                if (*ptr == 'u') { // u0a123 -> 10123
+                    const int userId = parseDigits(++ptr, 8);
+                    while ('0' <= *ptr && *ptr <= '9') ptr++;
+                    if (*ptr == 'a')
+                        uid = userId * 100000 + 10000 + parseDigits(ptr + 1, 8);
+                }
+                else uid = parseDigits(ptr, 8);
+                jobCnt++;
+            }
+            else if (uid >= 0 && (ptr = strstr(line, "Run time: earliest=")) != nullptr) {
+                // earliest 已过的任务在等待网络/充电/空闲等条件而非时间, 只按 latest 截止时间处理, 都没有则忽略
+                int sec;
+                if (parseDuration(ptr + 19, sec) && sec > 0)
+                    setWakeupDeadline(uid, now + sec);
+                else if ((ptr = strstr(ptr, "latest=")) != nullptr && parseDuration(ptr + 7, sec) && sec > 0)
+                    setWakeupDeadline(uid, now + sec);
+                uid = -1;
+            }
+            line = lineEnd ? lineEnd + 1 : nullptr;
+        }
+        return jobCnt;
+    }
+
+    void updateWakeupDeadline() {
+        START_TIME_COUNT;
+
+        if (!wakeupDumpBuff)
+            wakeupDumpBuff = make_unique<char[]>(WAKEUP_DUMP_BUF_SIZE);
+
+        const time_t now = time(nullptr);
+        wakeupDeadline.clear();
+        wakeupDeadlineTime = now;
+
+        const char* alarmCmd[] = { "/system/bin/dumpsys", "dumpsys", "alarm", nullptr };
+        VPOPEN::vpopen(alarmCmd[0], alarmCmd + 1, wakeupDumpBuff.get(), WAKEUP_DUMP_BUF_SIZE - 1);
+        const int alarmCnt = parseAlarmDump(wakeupDumpBuff.get(), now);
+
+        const char* jobCmd[] = { "/system/bin/dumpsys", "dumpsys", "jobscheduler", nullptr };
+        VPOPEN::vpopen(jobCmd[0], jobCmd + 1, wakeupDumpBuff.get(), WAKEUP_DUMP_BUF_SIZE - 1);
+        const int jobCnt = parseJobDump(wakeupDumpBuff.get(), now);
+
+        isWakeupDeadlineValid = alarmCnt > 0 || jobCnt > 0; // 都解析失败 则退回固定间隔解冻
+        freezeit.debugFmt("定时解冻调度: 闹钟 %d 任务 %d, 其中 %d 个应用有待办", alarmCnt, jobCnt,
+            (int)wakeupDeadline.size());
+
+        END_TIME_COUNT;
+    }
+
+    // 范围: 全局间隔的 1/4 ~ 8倍
+    int getAppWakeupInterval(const appInfoStruct& appInfo) const {
+        const int interval = settings.getWakeupTimeout();
+        if (appInfo.wakeupInterval <= 0) return interval;
+
+        const int minInterval = max(WAKEUP_INTERVAL_MIN, interval / 4);
+        const int maxInterval = max(minInterval, min(WAKEUP_INTERVAL_MAX, interval * 8));
+        return std::clamp(appInfo.wakeupInterval, minInterval, maxInterval);
+    }
+
+    // 定时解冻结束 重新冻结前调用
+    void updateWakeupInterval(appInfoStruct& appInfo) {
+        auto it = wakeupCpuStart.find(appInfo.uid);
+        if (it == wakeupCpuStart.end()) return;
+
+        const int cpuTimeMs = getAppCpuTimeMs(appInfo) - it->second;
+        wakeupCpuStart.erase(it);
+        if (cpuTimeMs < 0 || !settings.isWakeupEnable()) return;
+
+        const int interval = getAppWakeupInterval(appInfo);
+        if (cpuTimeMs < WAKEUP_IDLE_CPU_MS) appInfo.wakeupInterval = interval * 2;
+        else if (cpuTimeMs > WAKEUP_BUSY_CPU_MS) appInfo.wakeupInterval = interval / 2;
+        else appInfo.wakeupInterval = interval;
+
+        const int newInterval = getAppWakeupInterval(appInfo);
+        appInfo.wakeupInterval = newInterval;
+        if (newInterval == interval) return;
+
+        freezeit.debugFmt("%s 定时解冻CPU %dms, 解冻间隔 %d分 -> %d分", appInfo.label.c_str(), cpuTimeMs,
+            interval / 60, newInterval / 60);
+        managedApp.saveWakeup();
+    }
+
+    // 距离需要解冻还有多少秒, 0: 立即解冻
+    int getWakeupDelay(const appInfoStruct& appInfo) {
+        const time_t now = time(nullptr);
+        if (now - wakeupDeadlineTime >= WAKEUP_DEADLINE_REFRESH_SEC)
+            updateWakeupDeadline();
+        if (!isWakeupDeadlineValid) return 0;
+
+        const int interval = getAppWakeupInterval(appInfo);
+        const int ceiling = max(interval, min(interval * WAKEUP_CEILING_FACTOR, WAKEUP_CEILING_MAX));
+        const int frozenSec = static_cast<int>(now - appInfo.stopTimestamp);
+        if (frozenSec >= ceiling) return 0;
+
+        int delay = ceiling - frozenSec;
+        auto it = wakeupDeadline.find(appInfo.uid);
+        if (it != wakeupDeadline.end()) {
+            const int deadlineSec = static_cast<int>(it->second - now);
+            if (deadlineSec <= WAKEUP_DEADLINE_TOLERANCE) return 0;
+            delay = min(delay, deadlineSec);
         }
+        return min(delay, interval); // 至少每个间隔检查一次 以便发现新的待办
     }
 
-
     void checkWakeup() {
-        timelineIdx = (timelineIdx + 1) & 0x0FFF; // [ %4096]
-        const auto uid = unfrozenTimeline[timelineIdx];
-        if (uid == 0) return;
+        vector<int> batch;
+        {
+            lock_guard<mutex> lock(timelineMutex);
+            auto it = unfrozenTimeline.find(++timelineIdx);
+            if (it == unfrozenTimeline.end()) return;
+            batch = std::move(it->second);
+            unfrozenTimeline.erase(it);//清掉时间线当前时刻的批次
+        }
 
-        unfrozenTimeline[timelineIdx] = 0;//清掉时间线当前位置UID信息
+        int appCnt = 0, pidCnt = 0;
+        stackString<1024> tmp("☀️定时解冻");
+        for (const int uid : batch) {
+            if (!managedApp.contains(uid)) continue;
 
-        if (!managedApp.contains(uid)) return;
+            auto& appInfo = managedApp[uid];
+            appInfo.timelineUnfrozenIdx = -1;
+            if (!appInfo.isSignalOrFreezer()) continue;
+
+            const int delaySec = getWakeupDelay(appInfo);
+            if (delaySec > 0) { // 近期没有闹钟/任务, 推迟解冻
+                insertTimeline(appInfo, delaySec);
+                wakeupAvoidedCnt++;
+                if (doze.isScreenOffStandby) doze.wakeupAvoidedCnt++;
+                continue;
+            }
 
-        auto& appInfo = managedApp[uid];
-        if (appInfo.isSignalOrFreezer()) {
             const int num = handleProcess(appInfo, false);
             if (num > 0) {
                 appInfo.startTimestamp = time(nullptr);
-                pendingHandleList[uid] = settings.freezeTimeout;//更新待冻结倒计时
-                freezeit.logFmt("☀️定时解冻 %s %d进程", appInfo.label.c_str(), num);
+                pendingHandleList[uid] = settings.freezeTimeout;//同批次共用一个待冻结倒计时
+                wakeupCpuStart[uid] = getAppCpuTimeMs(appInfo);
+                startQuiescence(appInfo);
+                appCnt++;
+                pidCnt += num;
+                tmp.append(' ').append(appInfo.label.c_str());
             }
             else {
                 freezeit.logFmt("🗑️后台被杀 %s", appInfo.label.c_str());
             }
             appInfo.isFreeze = false;
         }
-        else {
-            appInfo.timelineUnfrozenIdx = -1;
+
+        if (appCnt) {
+            wakeupWindowCnt++;
+            wakeupBatchAppCnt += appCnt;
+            if (doze.isScreenOffStandby) doze.wakeupWindowCnt++;
+            tmp.appendFmt(" | %d应用 %d进程", appCnt, pidCnt);
+            freezeit.log(tmp.c_str(), tmp.length);
         }
     }
 
@@ -1335,8 +3149,16 @@ public:
             return "Freezer冻结";
         case FREEZE_MODE::FREEZER_BREAK:
             return "Freezer冻结断网";
+        case FREEZE_MODE::THROTTLE_CPU:
+            return "限制CPU";
+        case FREEZE_MODE::LITTLE_CORE:
+            return "小核运行";
+        case FREEZE_MODE::MEMORY_LIMIT:
+            return "限制内存";
         case FREEZE_MODE::WHITELIST:
             return "自由后台";
+        case FREEZE_MODE::SCREENOFF:
+            return "息屏冻结";
         case FREEZE_MODE::WHITEFORCE:
             return "自由后台(内置)";
         default:
@@ -1377,8 +3199,10 @@ public:
             if (remainTimesToRefreshTopApp > 0) {
                 remainTimesToRefreshTopApp--;       
                 if (doze.isScreenOffStandby && doze.checkIfNeedToExit()) {
+                    startThawPacing();
                     curForegroundApp = std::move(curFgBackup);
                     updateAppProcess();
+                    queueScreenOffThaw();
                 }
                 else {
                     if (systemTools.SDK_INT_VER >= 31) 
@@ -1386,12 +3210,97 @@ public:
                     else 
                         getVisibleAppByShellLRU();
                     updateAppProcess(); // ~40us
+                    checkPreThaw();
                 }   
             } 
+            processThawQueue();
             Utils::sleep_ms(Time_Ms);
         }
     }
 
+    static int64_t getSteadyMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // 正在触摸 或 刚结束手势
+    bool isUserActive() const {
+        return isTouching || (getSteadyMs() - lastTouchMs) < USER_ACTIVE_MS;
+    }
+
+    // 处理一批输入事件, 返回是否有手势结束
+    bool handleInputEvents(const input_event* events, const int cnt) {
+        bool isGestureEnd = false;
+        for (int i = 0; i < cnt; i++) {
+            const auto& ev = events[i];
+            bool isDown;
+            if (ev.type == EV_KEY && ev.code == BTN_TOUCH) isDown = ev.value != 0;
+            else if (ev.type == EV_ABS && ev.code == ABS_MT_TRACKING_ID) isDown = ev.value >= 0;
+            else continue;
+
+            if (isTouching && !isDown) isGestureEnd = true;
+            isTouching = isDown;
+        }
+        lastTouchMs = getSteadyMs();
+        return isGestureEnd;
+    }
+
+    // 只读不独占(不EVIOCGRAB), 息屏后关闭设备并阻塞等待亮屏
+    void inputThreadFunc() {
+        sleep(2);
+
+        const auto eventNums = Utils::getTouchEventNum();
+        if (eventNums.empty()) {
+            freezeit.log("未找到触摸输入设备, 手势触发前台刷新已关闭");
+            return;
+        }
+
+        stackString<128> tmp("监听触摸输入成功:");
+        for (const int num : eventNums)
+            tmp.appendFmt(" event%d", num);
+        freezeit.log(tmp.c_str(), tmp.length);
+
+        while (true) {
+            systemTools.waitScreenOn();
+
+            vector<pollfd> fds;
+            for (const int num : eventNums) {
+                char path[64];
+                FastSnprintf(path, sizeof(path), "/dev/input/event%d", num);
+                const int fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+                if (fd >= 0) fds.push_back({ fd, POLLIN, 0 });
+            }
+            if (fds.empty()) {
+                freezeit.logFmt("打开触摸输入设备失败 [%d]:[%s]", errno, strerror(errno));
+                return;
+            }
+
+            input_event events[64];
+            while (!systemTools.isScreenOff()) {
+                const int res = poll(fds.data(), fds.size(), INPUT_IDLE_POLL_MS);
+                if (res <= 0) {
+                    isTouching = false; // 长时间无事件 避免丢失抬起事件后一直处于触摸状态
+                    continue;
+                }
+
+                bool isGestureEnd = false;
+                for (auto& pfd : fds) {
+                    if (!(pfd.revents & POLLIN)) continue;
+                    ssize_t len;
+                    while ((len = read(pfd.fd, events, sizeof(events))) > 0)
+                        isGestureEnd |= handleInputEvents(events, len / sizeof(input_event));
+                }
+
+                if (isGestureEnd && remainTimesToRefreshTopApp < 2)
+                    remainTimesToRefreshTopApp = 2; // 手势结束 立即刷新前台
+            }
+
+            for (auto& pfd : fds)
+                close(pfd.fd);
+            isTouching = false;
+        }
+    }
+
     void cpuSetTriggerTask() {
         constexpr int TRIGGER_BUF_SIZE = 8192;
         constexpr int Count = 2;
@@ -1430,6 +3339,169 @@ public:
         freezeit.log("已退出监控同步事件: 0xB0");
     }
 
+    enum class REKERNEL_TYPE : uint8_t { UNKNOWN, BINDER, NETWORK, SIGNAL };
+    enum class REKERNEL_BINDER_TYPE : uint8_t { UNKNOWN, TRANSACTION, REPLY, FREE_BUFFER_FULL };
+
+    struct reKernelEvent {
+        REKERNEL_TYPE type = REKERNEL_TYPE::UNKNOWN;
+        REKERNEL_BINDER_TYPE binderType = REKERNEL_BINDER_TYPE::UNKNOWN;
+        bool oneway = false;
+        int targetPid = -1;
+        int targetUid = -1;
+    };
+
+    // 接收线程只做与应用状态无关的过滤后入队, 由主循环线程处理, 避免与冻结/解冻竞争应用状态
+    mutex binderEventMutex;
+    vector<reKernelEvent> binderEventQueue;
+    unordered_map<int, int64_t> binderEventLastHandle; // { uid, 上次处理时间ms } 仅主循环线程访问
+    std::atomic<bool> isBinderTraceActive = false;
+    std::shared_ptr<const unordered_map<int, int>> frozenPidSnapshot; // tracefs 过滤用: 冻结中的进程 { pid, uid }
+
+    void pushBinderEvent(const reKernelEvent& event) {
+        lock_guard<mutex> lock(binderEventMutex);
+        binderEventQueue.emplace_back(event);
+    }
+
+    // 主循环线程: 处理接收线程提交的Binder事件, 并为 tracefs 刷新冻结进程表
+    void processBinderEvents() {
+        vector<reKernelEvent> events;
+        {
+            lock_guard<mutex> lock(binderEventMutex);
+            events.swap(binderEventQueue);
+        }
+        if (events.empty()) return;
+
+        const int64_t nowMs = getSteadyMs();
+        for (const auto& event : events)
+            handleBinderEvent(event, nowMs, binderEventLastHandle);
+    }
+
+    void refreshFrozenPidSnapshot() {
+        if (!isBinderTraceActive) return;
+
+        auto pidMap = std::make_shared<unordered_map<int, int>>();
+        for (const auto& appInfo : managedApp.appInfoMap) {
+            if (appInfo.uid < ManagedApp::UID_START || !appInfo.isFreeze) continue;
+            for (const int pid : appInfo.pids)
+                (*pidMap)[pid] = appInfo.uid;
+        }
+        lock_guard<mutex> lock(binderEventMutex);
+        frozenPidSnapshot = std::move(pidMap);
+    }
+
+    static int parseDigits(const char* ptr, const size_t len) {
+        int res = 0;
+        for (size_t i = 0; i < len && '0' <= ptr[i] && ptr[i] <= '9'; i++)
+            res = res * 10 + (ptr[i] - '0');
+        return res;
+    }
+
+    // 解析 "type=Binder,bindertype=transaction,oneway=0,from_pid=x,from=x,target_pid=x,target=x;"
+    // 单次顺序扫描, 不分配内存, 未知字段直接跳过
+    static bool parseReKernelMsg(const char* msg, const size_t len, reKernelEvent& event) {
+        const char* ptr = msg;
+        const char* const end = msg + len;
+
+        while (ptr < end && *ptr && *ptr != ';') {
+            const char* key = ptr;
+            while (ptr < end && *ptr && *ptr != '=') ptr++;
+            if (ptr >= end || *ptr != '=') break;
+            const size_t keyLen = ptr - key;
+            const char* value = ++ptr;
+            while (ptr < end && *ptr && *ptr != ',' && *ptr != ';') ptr++;
+            const size_t valueLen = ptr - value;
+
+            switch (keyLen) {
+            case 4: // type
+                if (!memcmp(key, "type", 4)) {
+                    if (valueLen == 6 && !memcmp(value, "Binder", 6)) event.type = REKERNEL_TYPE::BINDER;
+                    else if (valueLen == 7 && !memcmp(value, "Network", 7)) event.type = REKERNEL_TYPE::NETWORK;
+                    else if (valueLen == 6 && !memcmp(value, "Signal", 6)) event.type = REKERNEL_TYPE::SIGNAL;
+                }
+                break;
+            case 6: // oneway target
+                if (!memcmp(key, "oneway", 6)) event.oneway = valueLen && *value == '1';
+                else if (!memcmp(key, "target", 6)) event.targetUid = parseDigits(value, valueLen);
+                break;
+            case 10: // bindertype target_pid
+                if (!memcmp(key, "bindertype", 10)) {
+                    if (valueLen == 11 && !memcmp(value, "transaction", 11))
+                        event.binderType = REKERNEL_BINDER_TYPE::TRANSACTION;
+                    else if (valueLen == 5 && !memcmp(value, "reply", 5))
+                        event.binderType = REKERNEL_BINDER_TYPE::REPLY;
+                    else if (valueLen == 16 && !memcmp(value, "free_buffer_full", 16))
+                        event.binderType = REKERNEL_BINDER_TYPE::FREE_BUFFER_FULL;
+                }
+                else if (!memcmp(key, "target_pid", 10)) event.targetPid = parseDigits(value, valueLen);
+                break;
+            default:
+                break;
+            }
+
+            if (ptr < end && *ptr == ',') ptr++;
+        }
+        return event.type != REKERNEL_TYPE::UNKNOWN;
+    }
+
+    // ReKernel / tracefs 共用: 对冻结中应用的Binder事件执行临时解冻
+    void handleBinderEvent(const reKernelEvent& event, const int64_t nowMs, unordered_map<int, int64_t>& lastHandleTime) {
+        constexpr int COALESCE_WINDOW_MS = 1000; // 同一UID在窗口内的连续事件只处理一次
+
+        if (event.targetUid < 0) {
+            binderEventFilterCnt++;
+            return;
+        }
+
+        const bool isBinderType = event.type == REKERNEL_TYPE::BINDER;
+        if (event.oneway && event.binderType != REKERNEL_BINDER_TYPE::FREE_BUFFER_FULL) {
+            binderEventFilterCnt++;
+            return;
+        }
+
+        const int uid = event.targetUid;
+
+        // 先检查是否存在，再访问
+        if (!managedApp.contains(uid)) {
+            binderEventFilterCnt++;
+            return;
+        }
+
+        auto& appInfo = managedApp[uid];
+        //appInfo.isPermissive && 
+        if (!appInfo.isFreeze || pendingHandleList.contains(uid)) {
+            binderEventFilterCnt++;
+            return;
+        }
+
+        // 目标进程已知, 只解冻该进程
+        const bool isKnownPid = isBinderType && event.targetPid > 0 &&
+            std::find(appInfo.pids.begin(), appInfo.pids.end(), event.targetPid) != appInfo.pids.end();
+
+        auto timeIt = lastHandleTime.find(uid);
+        if (timeIt != lastHandleTime.end() && nowMs - timeIt->second < COALESCE_WINDOW_MS &&
+            (!isKnownPid || isPartialThawing(event.targetPid))) {
+            binderEventCoalesceCnt++;
+            return;
+        }
+        lastHandleTime[uid] = nowMs;
+
+        if (lastHandleTime.size() > 256) {
+            erase_if(lastHandleTime, [nowMs](const auto& item) {
+                return nowMs - item.second >= COALESCE_WINDOW_MS;
+            });
+        }
+
+        if (isKnownPid) {
+            if (!isPartialThawing(event.targetPid))
+                freezeit.logFmt("[%s:%d] 接收到Binder信息, 类别: %s, 将局部临时解冻", 
+                    appInfo.label.c_str(), event.targetPid, event.oneway ? "ASYNC" : "SYNC");
+            partialThaw(appInfo, event.targetPid, TEMP_THAW_CEILING_SEC);
+            return;
+        }
+        freezeit.logFmt("[%s] 接收到Binder信息, 类别: %s 类型: %s, 将进行临时解冻", appInfo.label.c_str(), event.oneway ? "ASYNC" : "SYNC", isBinderType ? "临时解冻" : "网络解冻");     
+        unFreezerTemporary(uid, TEMP_THAW_CEILING_SEC);
+    }
+
     // Binder事件 需要额外magisk模块: ReKernel
     int binderEventTriggerTask(void) {
         if (!settings.enableunFreezerTemporary) return -1;
@@ -1437,8 +3509,6 @@ public:
         sleep(2); // 这里已经通知ReKernel清理了 uint 节点 不加会造成会ReKernel和NkBinder同时握手
 
         int skfd, ret;
-        user_msg_info u_info;
-        socklen_t len;
         struct nlmsghdr* nlh = nullptr;
         struct sockaddr_nl saddr, daddr;
         constexpr const char umsg[] = "Hello! Re:Kernel!";
@@ -1505,99 +3575,98 @@ public:
         // 老版本可能不支持该功能所以继续运行
         if (!ret) freezeit.logFmt("通知ReKernel清理 /proc/rekernel/%d 节点失败", NETLINK_UNIT);    
 
+        constexpr int BATCH_SIZE = 16;
+        user_msg_info msgBuf[BATCH_SIZE];
+        struct iovec iov[BATCH_SIZE];
+        struct mmsghdr msgs[BATCH_SIZE];
         while (true) {
-            memset(&u_info, 0, sizeof(u_info));
-            len = sizeof(struct sockaddr_nl);
-            ret = recvfrom(skfd, &u_info, sizeof(user_msg_info), 0, (struct sockaddr *)&daddr, &len);
-            if (!ret) {
+            memset(msgs, 0, sizeof(msgs));
+            for (int i = 0; i < BATCH_SIZE; i++) {
+                iov[i] = { &msgBuf[i], sizeof(user_msg_info) };
+                msgs[i].msg_hdr.msg_iov = &iov[i];
+                msgs[i].msg_hdr.msg_iovlen = 1;
+            }
+
+            const int msgCnt = recvmmsg(skfd, msgs, BATCH_SIZE, MSG_WAITFORONE, nullptr);
+            if (msgCnt <= 0) {
+                if (msgCnt < 0 && errno == EINTR) continue;
                 freezeit.log("从ReKernel接收消息失败！");
                 close(skfd);
                 return -1;
             }
 
-            const bool isBinderType = !strncmp(u_info.msg, "type=Binder", 11);
-            const char* ptr = strstr(u_info.msg, "target=");
-            const char* ptr1 = strstr(u_info.msg, "oneway=");
-            const char* ptr2 = strstr(u_info.msg, "bindertype=free_buffer_full");
-            const int oneway = (ptr1 != nullptr) ? Fastatoi(ptr1 + 7) : 0;
-            const bool isFreeBufferFull = (ptr2 != nullptr);
+            for (int i = 0; i < msgCnt; i++) {
+                const auto& msgInfo = msgBuf[i];
+                const size_t payloadLen = msgs[i].msg_len > sizeof(nlmsghdr) ? msgs[i].msg_len - sizeof(nlmsghdr) : 0;
 
-            #if DEBUG_DURATION
-                freezeit.logFmt("ReKernel发送的通知:%s", u_info.msg);
-            #endif
+                binderEventRecvCnt++;
 
-            if (ptr != nullptr) {
-                if (oneway == 1 && !isFreeBufferFull)
-                    continue;  
+                #if DEBUG_DURATION
+                    freezeit.logFmt("ReKernel发送的通知:%.*s", (int)payloadLen, msgInfo.msg);
+                #endif
 
-                const int uid = Fastatoi(ptr + 7);
-                
-                // 先检查是否存在，再访问
-                if (!managedApp.contains(uid))
+                reKernelEvent event;
+                if (!parseReKernelMsg(msgInfo.msg, payloadLen, event)) {
+                    binderEventFilterCnt++;
                     continue;
-                
-                auto& appInfo = managedApp[uid];
-                //appInfo.isPermissive && 
-                if (appInfo.isFreeze && !pendingHandleList.contains(uid)) {
-                    freezeit.logFmt("[%s] 接收到Re:Kernel的Binder信息, 类别: %s 类型: %s, 将进行临时解冻", managedApp[uid].label.c_str(), oneway ? "ASYNC" : "SYNC", isBinderType ? "临时解冻" : "网络解冻");     
-                    unFreezerTemporary(uid, 3);      
-                }              
-            }     
+                }
+                pushBinderEvent(event);
+            }
+
         }
         close(skfd);  
         free(nlh); 
     }
 
-    int NkBinderMagiskFunc(void) {
-        if (!settings.enableunFreezerTemporary || checkReKernel()) return -1;
+    // Binder事件 未安装ReKernel时使用内核 binder_transaction tracepoint
+    int binderTraceTask() {
+        if (!settings.enableunFreezerTemporary) return -1;
 
-        int skfd = socket(AF_LOCAL, SOCK_STREAM, 0);
-        int len;
-        struct sockaddr_un addr;
-        char buffer[128];
+        sleep(2);
+        if (checkReKernel()) return -1;
 
-        constexpr const char name[] = "nkbinder";
-        if (skfd < 0) {
-            freezeit.log("连接Bind失败");
-            return -1;
-        }
-    
-        addr.sun_family  = AF_LOCAL;
-        addr.sun_path[0]  = 0;  
-        memcpy(addr.sun_path + 1, name, sizeof(name));
-    
-        len = sizeof(name) + offsetof(struct sockaddr_un, sun_path);
-    
-        if (connect(skfd, (struct sockaddr*)&addr, len) < 0) {
-            freezeit.log("与nkbinder握手失败");
-            close(skfd);
+        BinderTrace binderTrace;
+        const char* errMsg = binderTrace.init("frozen");
+        if (errMsg) {
+            freezeit.logFmt("Binder事件(tracefs) 不可用: %s", errMsg);
             return -1;
         }
+        freezeit.log("已通过 tracefs 监听Binder事件");
 
-        freezeit.log("与NkBinder握手成功");
-        while (true) {
-            recv(skfd, buffer, sizeof(buffer), 0);
-
-            #if DEBUG_DURATION
-                printf("NkBinder: %s\n", buffer);
-            #endif
 
-            auto ptr = strstr(buffer, "from_uid=");
+        // 系统中的Binder通信非常多, 只关心目标为冻结进程的, 冻结进程表由主循环线程每秒刷新
+        isBinderTraceActive = true;
+        std::shared_ptr<const unordered_map<int, int>> frozenPidMap;
+        int64_t lastRefreshMs = 0;
 
-            if (ptr != nullptr) {
-                const int uid = Fastatoi(ptr + 9);
-                if (!managedApp.contains(uid))
-                    continue;
+        binderTrace.readLoop([&](const BinderTrace::binderTransaction& transaction) {
+            if (transaction.isReply) return;
 
-                auto& appInfo = managedApp[uid];
-                if (appInfo.isPermissive && appInfo.isFreeze && !pendingHandleList.contains(uid)) {
-                    freezeit.logFmt("[%s] 接收到NkBinder的Binder信息(SYNC), 类别: transaction, 将进行临时解冻", managedApp[uid].label.c_str());     
-                    unFreezerTemporary(uid, 3);      
-                } 
+            const int64_t nowMs = getSteadyMs();
+            if (nowMs - lastRefreshMs >= 1000) {
+                lastRefreshMs = nowMs;
+                lock_guard<mutex> lock(binderEventMutex);
+                frozenPidMap = frozenPidSnapshot;
             }
-            Utils::sleep_ms(40); //等待NkBinder处理完EBPF事件
-        }
-        close(skfd);
+            if (!frozenPidMap) return;
+
+            const auto it = frozenPidMap->find(transaction.toProc);
+            if (it == frozenPidMap->end()) return;
+
+            binderEventRecvCnt++;
+            const reKernelEvent event{
+                .type = REKERNEL_TYPE::BINDER,
+                .binderType = REKERNEL_BINDER_TYPE::TRANSACTION,
+                .oneway = transaction.isOneway,
+                .targetPid = transaction.toProc,
+                .targetUid = it->second,
+            };
+            pushBinderEvent(event);
+        });
+
+        isBinderTraceActive = false;
+        freezeit.log("已退出监听Binder事件(tracefs)");
+        return 0;
     }
 
     void cycleThreadFunc() { 
@@ -1605,19 +3674,58 @@ public:
         getVisibleAppByShell(); // 获取桌面
 
         while (true) {
-            Utils::sleep_ms(1000);
+            sleepWithQuiescence();
 
             systemTools.cycleCnt++;
 
+            updateAudioApp();
             processPendingApp();//1秒一次
+            processPartialThaw();
+            refreshFrozenPidSnapshot();
+
+            if (systemTools.cycleCnt % 30 == 0 && !isUserActive())
+                sampleBinderStats(); // 30秒一次 息屏也采样
+
+            if (deferredReclaimUids.size() && !isUserActive()) {
+                for (const int uid : deferredReclaimUids)
+                    if (managedApp.contains(uid) && managedApp[uid].isFreeze)
+                        MemoryRecycle(managedApp[uid]);
+                deferredReclaimUids.clear();
+            }
 
             // 2分钟一次 在亮屏状态检测是否已经息屏  息屏状态则检测是否再次强制进入深度Doze
             if (doze.checkIfNeedToEnter()) {
                 curFgBackup = std::move(curForegroundApp); //backup
                 updateAppProcess();
+                freezeScreenOffApps();
+            }
+
+            if (doze.updateStandbyTier())
+                handleStandbyTier(doze.standbyTier);
+
+            processPsiTask(); // 息屏也处理
+
+            if (doze.isScreenOffStandby) {
+                // 启用待机分级时, 暂停定时解冻前仍正常执行定时解冻
+                if (settings.isStandbyTierEnable()) {
+                    if (doze.standbyTier != STANDBY_TIER::HOLD_WAKEUP)
+                        checkWakeup();
+                    else
+                        wakeupHeldCnt += getTimelineBatchSize(timelineIdx + ++wakeupHoldSec);
+                }
+                continue;// 息屏状态 不用执行 以下功能
             }
 
-            if (doze.isScreenOffStandby)continue;// 息屏状态 不用执行 以下功能
+            if (wakeupHoldSec) {
+                if (wakeupHeldCnt)
+                    freezeit.logFmt("待机期间暂停定时解冻 %d次", wakeupHeldCnt);
+                wakeupHoldSec = wakeupHeldCnt = 0;
+            }
+
+            if (isDwellChanged && systemTools.cycleCnt % 600 == 0) { // 10分钟保存一次
+                managedApp.saveDwell();
+                isDwellChanged = false;
+            }
 
             systemTools.checkBattery();// 1分钟一次 电池检测
             checkUnFreeze();// 检查进程状态，按需临时解冻
@@ -1626,6 +3734,430 @@ public:
     }
 
 
+    // 应用常驻内存 单位 KiB
+    static int getAppRssKiB(const appInfoStruct& appInfo) {
+        int totalKiB = 0;
+        for (const int pid : appInfo.pids) {
+            char path[32], buff[128];
+            FastSnprintf(path, sizeof(path), "/proc/%d/statm", pid);
+            if (Utils::readString(path, buff, sizeof(buff) - 1) == 0) continue;
+            const char* ptr = strchr(buff, ' ');
+            if (ptr) totalKiB += atoi(ptr + 1) * 4;
+        }
+        return totalKiB;
+    }
+
+    struct memUsageStruct {
+        int rssKiB = 0;
+        int anonKiB = 0;
+    };
+
+    // 按 smaps_rollup 统计应用常驻内存及其中的匿名页, 不支持则退回 statm (仅总量)
+    static memUsageStruct getAppMemUsage(const appInfoStruct& appInfo) {
+        memUsageStruct usage;
+        for (const int pid : appInfo.pids) {
+            char path[40], buff[2048];
+            FastSnprintf(path, sizeof(path), "/proc/%d/smaps_rollup", pid);
+            if (Utils::readString(path, buff, sizeof(buff) - 1) == 0) {
+                FastSnprintf(path, sizeof(path), "/proc/%d/statm", pid);
+                if (Utils::readString(path, buff, sizeof(buff) - 1) == 0) continue;
+                const char* ptr = strchr(buff, ' ');
+                if (ptr) usage.rssKiB += atoi(ptr + 1) * 4;
+                continue;
+            }
+
+            const char* ptr = strstr(buff, "\nRss:");
+            if (ptr) usage.rssKiB += atoi(ptr + 5);
+            ptr = strstr(buff, "\nAnonymous:");
+            if (ptr) usage.anonKiB += atoi(ptr + 11);
+        }
+        return usage;
+    }
+
+    // 写入并返回 errno, 0:成功  (Utils::writeString 不检查写入结果)
+    static int writeWithErrno(const char* path, const char* value) {
+        const int fd = open(path, O_WRONLY);
+        if (fd < 0) return errno;
+        const int res = write(fd, value, strlen(value)) < 0 ? errno : 0;
+        close(fd);
+        return res;
+    }
+
+    // 后端1: cgroup v2 memory.reclaim, 回收整个 uid_xxx 的内存  新内核支持 swappiness 参数选择匿名/文件页
+    // 仅在系统已对应用分组启用 memory 控制器时使用, 不改变 cgroup 布局, 否则交给 process_madvise
+    bool reclaimByCgroup(const appInfoStruct& appInfo, const RECLAIM_TYPE type) {
+        {
+            lock_guard<mutex> lock(restrictMutex);
+            probeMemV2();
+        }
+        if (!isMemV2Ready || !isMemReclaimOk || !hasUidCgroup(appInfo)) return false;
+
+        const int curMiB = getUidMemoryMiB(appInfo);
+        if (curMiB <= 0) return false;
+
+        char path[128], value[64];
+        getUidCgroupPath(appInfo, path, sizeof(path));
+        strcat(path, "/memory.reclaim");
+        if (access(path, F_OK)) {
+            isMemReclaimOk = false;
+            return false;
+        }
+
+        if (type == RECLAIM_TYPE::ALL) {
+            FastSnprintf(value, sizeof(value), "%dM", curMiB);
+        }
+        else {
+            if (!isReclaimSwappinessOk) return false; // 无法区分匿名/文件页, 交给下一个后端
+            FastSnprintf(value, sizeof(value), "%dM swappiness=%d", curMiB, type == RECLAIM_TYPE::ANON ? 200 : 0);
+        }
+
+        const int res = writeWithErrno(path, value);
+        if (res == EINVAL && type != RECLAIM_TYPE::ALL) {
+            isReclaimSwappinessOk = false; // 旧内核不支持 swappiness 参数
+            return false;
+        }
+        return res == 0 || res == EAGAIN; // EAGAIN: 未能回收到指定的量, 但已回收了一部分
+    }
+
+    // 按 /proc/pid/maps 选出要回收的映射区域
+    static void getReclaimRanges(const int pid, const RECLAIM_TYPE type, vector<iovec>& ranges) {
+        char path[32];
+        FastSnprintf(path, sizeof(path), "/proc/%d/maps", pid);
+        ifstream file(path);
+        if (!file.is_open()) return;
+
+        string line;
+        while (getline(file, line)) {
+            // 7f12340000-7f12350000 rw-p 00000000 00:00 0        [anon:dalvik-main space]
+            unsigned long start = 0, end = 0;
+            char perms[8] = {};
+            int nameOffset = 0;
+            if (sscanf(line.c_str(), "%lx-%lx %7s %*s %*s %*s %n", &start, &end, perms, &nameOffset) < 3) continue;
+            if (perms[0] != 'r' || end <= start) continue;
+
+            const char* name = nameOffset > 0 ? line.c_str() + nameOffset : "";
+            const bool isAnon = name[0] == 0 || !strncmp(name, "[anon:", 6) || !strcmp(name, "[heap]") ||
+                !strncmp(name, "[stack", 6);
+            const bool isFile = name[0] == '/' && strncmp(name, "/dev/", 5); // 设备映射不能换出
+            if (type == RECLAIM_TYPE::ANON ? !isAnon : type == RECLAIM_TYPE::FILE_BACKED ? !isFile : !(isAnon || isFile))
+                continue;
+
+            ranges.push_back({ reinterpret_cast<void*>(start), end - start });
+        }
+    }
+
+    // 后端2: process_madvise(MADV_PAGEOUT) 经 pidfd 逐进程换出, 内核 5.10+
+    bool reclaimByMadvise(const appInfoStruct& appInfo, const RECLAIM_TYPE type) {
+        if (!isProcessMadviseOk) return false;
+
+        constexpr size_t IOV_BATCH = 512;
+        constexpr int advice = MADV_PAGEOUT;
+        vector<iovec> ranges;
+        for (const int pid : appInfo.pids) {
+            const int pidfd = static_cast<int>(syscall(__NR_pidfd_open, pid, 0));
+            if (pidfd < 0) {
+                if (errno == ENOSYS) {
+                    isProcessMadviseOk = false;
+                    freezeit.log("内存回收: 内核不支持 pidfd_open, 不再使用 process_madvise");
+                    return false;
+                }
+                continue;
+            }
+
+            ranges.clear();
+            getReclaimRanges(pid, type, ranges);
+
+            // 遇到无法换出的区域(如锁定的内存)时内核会停在该区域, 跳过它继续
+            size_t idx = 0;
+            while (idx < ranges.size()) {
+                const size_t cnt = min(IOV_BATCH, ranges.size() - idx);
+                const ssize_t advised = syscall(__NR_process_madvise, pidfd, ranges.data() + idx, cnt, advice, 0);
+                if (advised < 0) {
+                    if (errno == ENOSYS || errno == EPERM) {
+                        close(pidfd);
+                        isProcessMadviseOk = false;
+                        freezeit.logFmt("内存回收: process_madvise 不可用 [%d]:[%s]", errno, strerror(errno));
+                        return false;
+                    }
+                    idx++; // 首个区域即失败
+                    continue;
+                }
+
+                size_t doneBytes = static_cast<size_t>(advised), done = 0;
+                while (done < cnt && doneBytes >= ranges[idx + done].iov_len)
+                    doneBytes -= ranges[idx + done++].iov_len;
+                idx += done < cnt ? done + 1 : done;
+            }
+            close(pidfd);
+        }
+        return true;
+    }
+
+    // 后端3: 部分厂商内核的 /proc/pid/reclaim
+    bool reclaimByProcReclaim(const appInfoStruct& appInfo, const RECLAIM_TYPE type) {
+        const char* typeStr = type == RECLAIM_TYPE::ANON ? "anon" : type == RECLAIM_TYPE::FILE_BACKED ? "file" : "all";
+        char path[32];
+        bool isOk = false;
+        for (const int pid : appInfo.pids) {
+            FastSnprintf(path, sizeof(path), "/proc/%d/reclaim", pid);
+            if (writeWithErrno(path, typeStr) == 0) isOk = true;
+        }
+        return isOk;
+    }
+
+    struct reclaimResultStruct {
+        int freedKiB = 0;     // 常驻内存减少量
+        int anonKiB = 0;      // 其中的匿名页
+        const char* backend = "无";
+    };
+
+    // 回收应用内存: memory.reclaim -> process_madvise -> /proc/pid/reclaim, 前一个不可用才使用下一个
+    reclaimResultStruct reclaimAppMemory(const appInfoStruct& appInfo, const RECLAIM_TYPE type) {
+        reclaimResultStruct result;
+        const auto before = getAppMemUsage(appInfo);
+
+        if (reclaimByCgroup(appInfo, type)) result.backend = "memory.reclaim";
+        else if (reclaimByMadvise(appInfo, type)) result.backend = "process_madvise";
+        else if (reclaimByProcReclaim(appInfo, type)) result.backend = "/proc/pid/reclaim";
+        else return result;
+
+        const auto after = getAppMemUsage(appInfo);
+        result.freedKiB = max(0, before.rssKiB - after.rssKiB);
+        result.anonKiB = min(result.freedKiB, max(0, before.anonKiB - after.anonKiB));
+        return result;
+    }
+
+    // 杀死冻结中的应用  V1 freezer 冻结的进程要解冻后才会处理 SIGKILL
+    int terminateFrozenApp(appInfoStruct& appInfo) {
+        const int freeKiB = getAppRssKiB(appInfo);
+        if (workMode == WORK_MODE::V1FROZEN && (appInfo.isFreezeMode() || appInfo.isScreenOffMode()))
+            handleFreezer(appInfo, false);
+        handleSignal(appInfo, SIGKILL);
+
+        removeTimeline(appInfo);
+        appInfo.pids.clear();
+        appInfo.isFreeze = false;
+        return freeKiB;
+    }
+
+    // 待机分级 在循环线程执行, 与其他修改应用状态的流程不会同时进行
+    void handleStandbyTier(const STANDBY_TIER tier) {
+        const int standbyMin = static_cast<int>(time(nullptr) - doze.standbyStartTime) / 60;
+
+        switch (tier) {
+        case STANDBY_TIER::RECLAIM: {
+            int appCnt = 0, reclaimKiB = 0;
+            for (const auto& appInfo : managedApp.appInfoMap) {
+                if (appInfo.uid < ManagedApp::UID_START || !appInfo.isFreeze || appInfo.pids.empty()) continue;
+                reclaimKiB += reclaimAppMemory(appInfo, RECLAIM_TYPE::ALL).freedKiB;
+                appCnt++;
+            }
+            freezeit.logFmt("🌙息屏%d分钟 回收冻结应用内存 %d应用 %dMiB", standbyMin, appCnt, reclaimKiB >> 10);
+        } break;
+
+        case STANDBY_TIER::TERMINATE: {
+            // 累计运行时长最短的三分之一冻结应用 视为价值最低, 息屏前位于前台的应用除外
+            vector<appInfoStruct*> candidates;
+            for (auto& appInfo : managedApp.appInfoMap) {
+                if (appInfo.uid < ManagedApp::UID_START || !appInfo.isFreeze || appInfo.pids.empty() ||
+                    appInfo.isSystemApp || appInfo.isAudioPlaying || curFgBackup.contains(appInfo.uid)) continue;
+                candidates.emplace_back(&appInfo);
+            }
+            std::sort(candidates.begin(), candidates.end(), [](const auto* a, const auto* b) {
+                return a->totalRunningTime < b->totalRunningTime;
+            });
+
+            int freeKiB = 0;
+            stackString<1024> tmp;
+            const size_t killCnt = candidates.size() / 3;
+            for (size_t i = 0; i < killCnt; i++) {
+                freeKiB += terminateFrozenApp(*candidates[i]);
+                tmp.append(' ').append(candidates[i]->label.c_str());
+            }
+            if (killCnt)
+                freezeit.logFmt("🌙息屏%d分钟 杀死%d个冻结应用 释放%dMiB:%s", standbyMin, (int)killCnt, freeKiB >> 10,
+                    tmp.c_str());
+        } break;
+
+        case STANDBY_TIER::HOLD_WAKEUP:
+            freezeit.logFmt("🌙息屏%d分钟 暂停定时解冻", standbyMin);
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    // 读取当前内存压力 如 "some 12.34% full 3.21%" (avg10)
+    void getPsiLevel(char* buff, const size_t size) {
+        char content[256];
+        if (Utils::readString(psiMemoryPath, content, sizeof(content) - 1) == 0) {
+            FastSnprintf(buff, size, "未知");
+            return;
+        }
+
+        const char* someAvg = strstr(content, "some avg10=");
+        const char* fullAvg = strstr(content, "full avg10=");
+        snprintf(buff, size, "some %.2f%% full %.2f%%", someAvg ? atof(someAvg + 11) : 0.0,
+            fullAvg ? atof(fullAvg + 11) : 0.0);
+    }
+
+    // 回收冻结最久, 且本次冻结后尚未因内存压力回收过的应用
+    int psiReclaim(const char* trigger, const char* level) {
+        vector<appInfoStruct*> candidates;
+        for (auto& appInfo : managedApp.appInfoMap) {
+            if (appInfo.uid < ManagedApp::UID_START || !appInfo.isFreeze || appInfo.pids.empty()) continue;
+            const auto it = psiReclaimTime.find(appInfo.uid);
+            if (it != psiReclaimTime.end() && it->second >= appInfo.stopTimestamp) continue;
+            candidates.emplace_back(&appInfo);
+        }
+        if (candidates.empty()) return 0;
+
+        std::sort(candidates.begin(), candidates.end(), [](const auto* a, const auto* b) {
+            return a->stopTimestamp < b->stopTimestamp;
+        });
+
+        const time_t now = time(nullptr);
+        int appCnt = 0, reclaimKiB = 0;
+        stackString<1024> tmp;
+        for (auto* appInfo : candidates) {
+            if (appCnt >= PSI_RECLAIM_APP_CNT) break;
+            reclaimKiB += reclaimAppMemory(*appInfo, RECLAIM_TYPE::ALL).freedKiB;
+            psiReclaimTime[appInfo->uid] = now;
+            tmp.append(' ').append(appInfo->label.c_str());
+            appCnt++;
+        }
+
+        psiReclaimCnt += appCnt;
+        psiReclaimKiB += reclaimKiB;
+        freezeit.logFmt("🔥内存压力[%s] %s 回收冻结最久的%d个应用 %dMiB:%s", trigger, level, appCnt, reclaimKiB >> 10,
+            tmp.c_str());
+        return appCnt;
+    }
+
+    // 杀死价值最低(累计运行时长最短)的一个冻结应用
+    int psiTerminate(const char* trigger, const char* level) {
+        appInfoStruct* target = nullptr;
+        for (auto& appInfo : managedApp.appInfoMap) {
+            if (appInfo.uid < ManagedApp::UID_START || !appInfo.isFreeze || appInfo.pids.empty() ||
+                appInfo.isSystemApp || appInfo.isAudioPlaying || curFgBackup.contains(appInfo.uid)) continue;
+            if (target == nullptr || appInfo.totalRunningTime < target->totalRunningTime)
+                target = &appInfo;
+        }
+        if (target == nullptr) {
+            freezeit.logFmt("🔥内存压力[%s] %s 已无可处理的冻结应用", trigger, level);
+            return 0;
+        }
+
+        const int freeKiB = terminateFrozenApp(*target);
+
+        psiKillCnt++;
+        psiKillKiB += freeKiB;
+        freezeit.logFmt("🔥内存压力[%s] %s 杀死冻结应用 %s 释放%dMiB", trigger, level, target->label.c_str(),
+            freeKiB >> 10);
+        return 1;
+    }
+
+    // 由主循环线程执行PSI线程提交的处理
+    void processPsiTask() {
+        psiTaskStruct task;
+        {
+            lock_guard<mutex> lock(psiTaskMutex);
+            if (!psiTask.isPending) return;
+            task = psiTask;
+            psiTask.isPending = false;
+        }
+
+        const char* trigger = task.isFull ? "full" : "some";
+        // 第一级回收; 回收后压力仍持续, 或已无可回收的应用, 则杀死
+        if (task.needTerminate || psiReclaim(trigger, task.level) == 0)
+            psiTerminate(trigger, task.level);
+    }
+
+    void closePsiTrigger(struct pollfd* fds) {
+        for (int i = 0; i < 2; i++) {
+            if (fds[i].fd >= 0) close(fds[i].fd);
+            fds[i].fd = -1;
+        }
+    }
+
+    bool registerPsiTrigger(struct pollfd* fds) {
+        const char* triggers[] = { PSI_SOME_TRIGGER, PSI_FULL_TRIGGER };
+        for (int i = 0; i < 2; i++) {
+            fds[i].fd = open(psiMemoryPath, O_RDWR | O_NONBLOCK);
+            fds[i].events = POLLPRI;
+            if (fds[i].fd < 0 || write(fds[i].fd, triggers[i], strlen(triggers[i]) + 1) < 0) {
+                freezeit.logFmt("内存压力监控 不可用: 无法注册PSI触发器[%s] [%d]:[%s]", triggers[i], errno,
+                    strerror(errno));
+                closePsiTrigger(fds);
+                return false;
+            }
+        }
+        freezeit.log("已注册内存压力(PSI)触发器");
+        return true;
+    }
+
+    // 开关可随时切换: 关闭时注销触发器, 开启时重新注册; 注册失败则等到下次开启再尝试
+    void memoryPressureThreadFunc() {
+        struct pollfd fds[2] = {};
+        fds[0].fd = fds[1].fd = -1;
+        bool isFailed = false;
+        int step = 0;
+        time_t lastActionTime = 0;
+        while (true) {
+            if (!settings.enableMemoryPressure) {
+                if (fds[0].fd >= 0) {
+                    closePsiTrigger(fds);
+                    freezeit.log("已注销内存压力(PSI)触发器");
+                }
+                isFailed = false;
+                Utils::sleep_ms(PSI_RECHECK_MS);
+                continue;
+            }
+            if (fds[0].fd < 0) {
+                if (isFailed || !registerPsiTrigger(fds)) {
+                    isFailed = true;
+                    Utils::sleep_ms(PSI_RECHECK_MS);
+                    continue;
+                }
+                step = 0;
+                lastActionTime = 0;
+            }
+
+            const int ret = poll(fds, 2, PSI_RECHECK_MS);
+            if (ret < 0) {
+                if (errno == EINTR) continue;
+                freezeit.logFmt("内存压力监控 poll错误 [%d]:[%s]", errno, strerror(errno));
+                closePsiTrigger(fds);
+                isFailed = true;
+                continue;
+            }
+            if (ret == 0) continue;
+            if ((fds[0].revents | fds[1].revents) & POLLERR) {
+                freezeit.log("内存压力监控 PSI触发器已失效");
+                closePsiTrigger(fds);
+                isFailed = true;
+                continue;
+            }
+
+            const time_t now = time(nullptr);
+            if (now - lastActionTime < PSI_ACTION_GAP_SEC) continue;
+
+            const bool isFull = fds[1].revents & POLLPRI;
+            // 60秒内未触发则回到第一级; 10秒内再次触发, 或回收后出现 full 则升级
+            if (now - lastActionTime > PSI_RESET_SEC) step = 0;
+            else if (isFull || now - lastActionTime <= PSI_ESCALATE_SEC) step++;
+            lastActionTime = now;
+
+            lock_guard<mutex> lock(psiTaskMutex);
+            if (!psiTask.isPending) psiTask = {};
+            psiTask.isPending = true;
+            psiTask.isFull |= isFull;
+            psiTask.needTerminate |= step >= 1;
+            getPsiLevel(psiTask.level, sizeof(psiTask.level));
+        }
+    }
+
     void getBlackListUidRunning(set<int>& uids) {
         uids.clear();
 
@@ -10,6 +10,9 @@ class ManagedApp {
 private:
     static constexpr const char* cfgPath = "/data/adb/modules/Frozen/appcfg.txt";
     static constexpr const char* labelPath = "/data/adb/modules/Frozen/applabel.txt";
+    static constexpr const char* wakeupPath = "/data/adb/modules/Frozen/appwakeup.txt";
+    static constexpr const char* dwellPath = "/data/adb/modules/Frozen/appdwell.txt";
+    static constexpr const char* reclaimPath = "/data/adb/modules/Frozen/appreclaim.txt";
 
     Freezeit& freezeit;
     Settings& settings;
@@ -432,7 +435,11 @@ public:
             FREEZE_MODE::SIGNAL_BREAK,
             FREEZE_MODE::FREEZER,
             FREEZE_MODE::FREEZER_BREAK,
+            FREEZE_MODE::THROTTLE_CPU,
+            FREEZE_MODE::LITTLE_CORE,
+            FREEZE_MODE::MEMORY_LIMIT,
             FREEZE_MODE::WHITELIST,
+            FREEZE_MODE::SCREENOFF,
             FREEZE_MODE::WHITEFORCE,
     };
 
@@ -443,6 +450,9 @@ public:
 
         updateAppList();
         loadLabelFile();
+        loadWakeupFile();
+        loadDwellFile();
+        loadReclaimFile();
 
         loadConfigFile2CfgTemp();
         updateIME2CfgTemp();
@@ -465,6 +475,7 @@ public:
     bool contains(const string& package) const { return uidIndex.contains(package); }
 
     bool isBlackList(const int uid) { return contains(uid) && appInfoMap[uid - UID_START].isBlacklist(); }
+    bool isScreenOffMode(const int uid) { return contains(uid) && appInfoMap[uid - UID_START].isScreenOffMode(); }
 
     auto& getLabel(const int uid) { return appInfoMap[uid - UID_START].label; }
 
@@ -477,6 +488,11 @@ public:
 
     bool hasHomePackage() const { return homePackage.length() > 2; }
 
+    int getHomeUid() const {
+        auto it = uidIndex.find(homePackage);
+        return it != uidIndex.end() ? it->second : -1;
+    }
+
     void updateHomePackage(const string& package) {
         homePackage = package;
         const auto& it = uidIndex.find(package);
@@ -862,6 +878,104 @@ public:
         file.close();
     }
 
+    // package interval
+    void loadWakeupFile() {
+        ifstream file(wakeupPath);
+        if (!file.is_open())
+            return;
+
+        string line;
+        while (getline(file, line)) {
+            const auto splitIdx = line.find(' ');
+            if (splitIdx == string::npos) continue;
+
+            auto it = uidIndex.find(line.substr(0, splitIdx));
+            if (it != uidIndex.end() && contains(it->second))
+                appInfoMap[it->second - UID_START].wakeupInterval = Fastatoi(line.c_str() + splitIdx + 1);
+        }
+        file.close();
+    }
+
+    void saveWakeup() {
+        string tmp;
+        tmp.reserve(1024L * 4);
+        for (const auto& appInfo : appInfoMap) {
+            if (appInfo.uid < UID_START || appInfo.wakeupInterval <= 0) continue;
+            tmp += appInfo.package;
+            tmp += ' ';
+            tmp += to_string(appInfo.wakeupInterval);
+            tmp += '\n';
+        }
+
+        if (!Utils::writeString(wakeupPath, tmp.c_str(), tmp.length()))
+            freezeit.logFmt("保存定时解冻间隔失败: [%s]", wakeupPath);
+    }
+
+    // package c0 c1 c2 c3 c4 c5 c6
+    void loadDwellFile() {
+        ifstream file(dwellPath);
+        if (!file.is_open())
+            return;
+
+        string line;
+        while (getline(file, line)) {
+            auto value = Utils::splitString(line, " ");
+            if (value.size() != appInfoStruct::DWELL_BUCKET_CNT + 1) continue;
+
+            auto it = uidIndex.find(value[0]);
+            if (it == uidIndex.end() || !contains(it->second)) continue;
+
+            auto& appInfo = appInfoMap[it->second - UID_START];
+            for (int i = 0; i < appInfoStruct::DWELL_BUCKET_CNT; i++)
+                appInfo.dwellHist[i] = static_cast<uint16_t>(Fastatoi(value[i + 1].c_str()));
+        }
+        file.close();
+    }
+
+    void saveDwell() {
+        string tmp;
+        tmp.reserve(1024L * 8);
+        for (const auto& appInfo : appInfoMap) {
+            if (appInfo.uid < UID_START) continue;
+
+            int total = 0;
+            for (const auto cnt : appInfo.dwellHist) total += cnt;
+            if (total == 0) continue;
+
+            tmp += appInfo.package;
+            for (const auto cnt : appInfo.dwellHist) {
+                tmp += ' ';
+                tmp += to_string(cnt);
+            }
+            tmp += '\n';
+        }
+
+        if (!Utils::writeString(dwellPath, tmp.c_str(), tmp.length()))
+            freezeit.logFmt("保存前后台切换记录失败: [%s]", dwellPath);
+    }
+
+    // package file/anon/all  未列出的应用只回收文件页
+    void loadReclaimFile() {
+        ifstream file(reclaimPath);
+        if (!file.is_open())
+            return;
+
+        string line;
+        while (getline(file, line)) {
+            auto value = Utils::splitString(line, " ");
+            if (value.size() != 2) continue;
+
+            auto it = uidIndex.find(value[0]);
+            if (it == uidIndex.end() || !contains(it->second)) continue;
+
+            auto& appInfo = appInfoMap[it->second - UID_START];
+            if (value[1] == "anon") appInfo.reclaimType = RECLAIM_TYPE::ANON;
+            else if (value[1] == "all") appInfo.reclaimType = RECLAIM_TYPE::ALL;
+            else appInfo.reclaimType = RECLAIM_TYPE::FILE_BACKED;
+        }
+        file.close();
+    }
+
     void loadLabel(const map<int, string>& labelList) {
         for (auto& [uid, label] : labelList)
             if (contains(uid))
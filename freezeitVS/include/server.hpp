@@ -267,6 +267,12 @@ public:
             replyLen = intCnt * sizeof(int);
         } break;
 
+        case MANAGER_CMD::getBinderStats: {
+            replyPtr = replyBuf.get();
+            replyLen = freezer.getBinderStats(reinterpret_cast<int*>(replyBuf.get()),
+                REPLY_BUF_SIZE / sizeof(int)) * sizeof(int);
+        } break;
+
         case MANAGER_CMD::getXpLog: {
             const int len = Utils::localSocketRequest(XPOSED_CMD::GET_XP_LOG, nullptr, 0, (int*)replyBuf.get(), REPLY_BUF_SIZE);
             if (len == 0) {
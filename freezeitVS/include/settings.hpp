@@ -19,9 +19,9 @@ private:
             20, //[4] terminateTimeout sec
             0,  //[5] setMode 设置Freezer模式  0: v2frozen(默认), 1: v2uid, 2: 全局SIGSTOP
             2,  //[6] refreezeTimeoutIdx 定时压制 参数索引 0-3：关闭, 30m, 1h, 2h
-            0,  //[7]
-            0,  //[8]
-            0,  //[9]
+            0,  //[7] standbyTierIdx 待机分级 参数索引 0-3：关闭, 标准, 积极, 保守
+            0,  //[8] thawBatchSize 亮屏解冻 每200ms解冻的应用数 0:默认
+            0,  //[9] memoryHighLimit 后台内存上限 0:默认(前台峰值的50%) 1-100:百分比 101-255:固定值
             1,  //[10] 
             0,  //[11]
             0,  //[12]
@@ -37,8 +37,8 @@ private:
             0,  //[22] 调整 lmk 参数
             0,  //[23] 深度Doze
             0,  //[24] 打印日志
-            0,  //[25]
-            0,  //[26]
+            0,  //[25] 断网方式 0:原生(sock_diag) 1:Xposed
+            0,  //[26] 内存压力监控
             0,  //[27]
             1,  //[28] 
             1,  //[29] 
@@ -53,6 +53,15 @@ private:
     // 最大索引
     static constexpr int refreezeTimeoutIdxMax = sizeof(refreezeTimeoutList) / sizeof(refreezeTimeoutList[0]) - 1;
 
+    // 待机分级 各阶段的息屏时长(秒): 回收内存, 杀死应用, 暂停定时解冻
+    static constexpr int standbyTierList[][3] = {
+        { 86400 * 365, 86400 * 365, 86400 * 365 },  // 关闭
+        { 60 * 30, 3600 * 2, 3600 * 4 },            // 标准
+        { 60 * 15, 3600, 3600 * 2 },                // 积极
+        { 3600, 3600 * 4, 3600 * 8 },               // 保守
+    };
+    static constexpr int standbyTierIdxMax = sizeof(standbyTierList) / sizeof(standbyTierList[0]) - 1;
+
     // 关闭, 5m, 15m, 30m, 1h, 2h
     static constexpr int wakeupTimeoutList[] = { 86400 * 365, 60 * 5, 60 * 15, 60 * 30, 3600, 3600 * 2 };
     // 最大索引
@@ -67,6 +76,9 @@ public:
     uint8_t& terminateTimeout = settingsVar[4];               // 超时杀死 单位 秒
     uint8_t& setMode = settingsVar[5];                        // Freezer模式
     uint8_t& refreezeTimeoutIdx = settingsVar[6];             // 定时压制 参数索引 0-3：关闭, 30m, 1h, 2h
+    uint8_t& standbyTierIdx = settingsVar[7];                 // 待机分级 参数索引 0-3：关闭, 标准, 积极, 保守
+    uint8_t& thawBatchSize = settingsVar[8];                  // 亮屏解冻 每200ms解冻的应用数 0:默认
+    uint8_t& memoryHighLimit = settingsVar[9];                // 后台内存上限 0:默认(前台峰值的50%) 1-100:百分比 101-255:固定值
 
     uint8_t& enableBatteryMonitor = settingsVar[13];          // 电池监控
     uint8_t& enableCurrentFix = settingsVar[14];              // 电池电流校准
@@ -81,6 +93,8 @@ public:
     uint8_t& enableLMK = settingsVar[22];                     // 后台优化
     uint8_t& enableDoze = settingsVar[23];                    // 深度Doze
     uint8_t& enableWriteLog = settingsVar[24];                // 打印日志
+    uint8_t& breakNetworkMode = settingsVar[25];              // 断网方式 0:原生(sock_diag) 1:Xposed
+    uint8_t& enableMemoryPressure = settingsVar[26];          // 内存压力监控 (PSI)
 
     uint8_t& enableDebug = settingsVar[30];                   // 调试日志
 
@@ -127,6 +141,11 @@ public:
                     freezeit.logFmt("定时解冻参数[%d]错误, 已重置为 %d 分钟",
                         static_cast<int>(wakeupTimeoutIdx), wakeupTimeoutList[wakeupTimeoutIdx] / 60);
                 }
+                if (standbyTierIdx > standbyTierIdxMax) {
+                    isError = true;
+                    standbyTierIdx = 0;
+                    freezeit.log("待机分级参数错误, 已重置为关闭");
+                }
                 if (freezeTimeout < 1 || 60 < freezeTimeout) {
                     isError = true;
                     freezeTimeout = 10;
@@ -177,6 +196,28 @@ public:
         return wakeupTimeoutList[wakeupTimeoutIdx <= wakeupTimeoutIdxMax ? wakeupTimeoutIdx : 0];
     }
 
+    bool isStandbyTierEnable() const {
+        return 0 < standbyTierIdx && standbyTierIdx <= standbyTierIdxMax;
+    }
+    // 进入该阶段所需的息屏时长(秒)
+    int getStandbyTierTimeout(const STANDBY_TIER tier) const {
+        if (tier == STANDBY_TIER::FREEZE) return 0;
+        return standbyTierList[standbyTierIdx <= standbyTierIdxMax ? standbyTierIdx : 0][static_cast<int>(tier) - 1];
+    }
+
+    // 1-8, 默认2
+    int getThawBatchSize() const {
+        return (0 < thawBatchSize && thawBatchSize <= 8) ? thawBatchSize : 2;
+    }
+
+    // 后台内存上限(MiB)  1-100: 前台峰值的百分比, 最低64MiB  101-255: 固定值 (x-100)*16MiB  无峰值记录返回 -1
+    int getMemoryHighMiB(const int peakMiB) const {
+        if (memoryHighLimit > 100) return (memoryHighLimit - 100) * 16;
+        if (peakMiB <= 0) return -1;
+        const int percent = memoryHighLimit ? memoryHighLimit : 50;
+        return max(peakMiB * percent / 100, 64);
+    }
+
     bool save() {
         lock_guard<mutex> lock(writeSettingMutex);
         auto fd = open(settingsPath, O_WRONLY | O_TRUNC | O_CREAT, 0666);
@@ -225,6 +266,24 @@ public:
         }
               break;
 
+        case 7: { // standbyTierIdx
+            if (val > standbyTierIdxMax)
+                return FastSnprintf(replyBuf, REPLY_BUF_SIZE, "待机分级参数错误, 欲设为:%d", val);
+        }
+              break;
+
+        case 8: { // thawBatchSize
+            if (val > 8)
+                return FastSnprintf(replyBuf, REPLY_BUF_SIZE, "亮屏解冻并发参数错误, 正常范围:0-8, 欲设为:%d", val);
+        }
+              break;
+
+        case 9: { // memoryHighLimit
+            if (val > 255)
+                return FastSnprintf(replyBuf, REPLY_BUF_SIZE, "后台内存上限参数错误, 正常范围:0-255, 欲设为:%d", val);
+        }
+              break;
+
         case 10: // xxx
         case 11: // xxx
         case 12: // xxx
@@ -240,8 +299,8 @@ public:
         case 22: // 后台优化
         case 23: // doze
         case 24: //
-        case 25: //
-        case 26: //
+        case 25: // 断网方式
+        case 26: // 内存压力监控
         case 27: //
         case 28: // 
         case 29: // 
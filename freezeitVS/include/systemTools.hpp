@@ -3,6 +3,11 @@
 #include "utils.hpp"
 #include "settings.hpp"
 #include "freezeit.hpp"
+#include <linux/netlink.h>
+#include <linux/sock_diag.h>
+#include <linux/inet_diag.h>
+#include <netinet/tcp.h>
+#include <poll.h>
 
 class SystemTools {
 private:
@@ -10,6 +15,15 @@ private:
     Settings& settings;
 
     thread sndThread;
+    thread screenThread;
+    thread powerThread;
+
+    const prop_info* screenPropInfo = nullptr;
+
+    static constexpr size_t AUDIO_DUMP_BUF_SIZE = 512 * 1024;
+    unique_ptr<char[]> audioDumpBuff;
+    unordered_set<int> audioUids;   // 正在播放音频的应用
+    mutex audioUidMutex;
 
     constexpr static uint32_t COLOR_E = 0XFF22BB44; // efficiency
     constexpr static uint32_t COLOR_M = 0XFFDD6622; // performance
@@ -38,6 +52,7 @@ public:
     };
     int cpuCluster = 0;    // 44(4+4), 431(4+3+1), 62(6+2) ...
     int cpuCoreTotal = 0;  // 全部核心数量
+    string littleCoreList; // 最低频集群的核心 cpuset格式 如 "0-3"  只有一个集群时为空
     int cpuCoreOnline = 0; // 当前可用核心数量
     uint32_t cycleCnt = 0; // 核心循环计数，约每秒+1
 
@@ -56,6 +71,14 @@ public:
     bool isAudioPlaying = false;
     // bool isMicrophoneRecording = false;
 
+    std::atomic<uint32_t> audioUidVersion = 0; // 播放音频的应用有变化时 +1
+
+    // 由监听线程更新, 读取无需系统调用
+    std::atomic<int> screenState = -1;  // debug.tracing.screen_state  -1:未知 1:息屏 2:亮屏 ...
+    std::atomic<int> chargeState = -1;  // -1:未知 0:未充电 1:充电中或已充满
+    std::condition_variable screenCv;    // 屏幕状态变化时通知
+    mutex screenMutex;
+
     uint32_t extMemorySize = 0; // MiB
 
     int ANDROID_VER = 0;
@@ -93,7 +116,10 @@ public:
 
         InitLMK();
 
+        audioDumpBuff = make_unique<char[]>(AUDIO_DUMP_BUF_SIZE);
         sndThread = thread(&SystemTools::sndThreadFunc, this);
+        screenThread = thread(&SystemTools::screenThreadFunc, this);
+        powerThread = thread(&SystemTools::powerThreadFunc, this);
 
         extMemorySize = getExtMemorySize();
     }
@@ -181,17 +207,15 @@ public:
     }
 
     int getScreenProperty() {
-        static const prop_info* pi = nullptr;
-
-        if (pi == nullptr) {
-            pi = __system_property_find("debug.tracing.screen_state");
-            if (pi == nullptr) {
+        if (screenPropInfo == nullptr) {
+            screenPropInfo = __system_property_find("debug.tracing.screen_state");
+            if (screenPropInfo == nullptr) {
                 return -1;
             }
         }
 
         char res[PROP_VALUE_MAX] = { 0 };
-        __system_property_read_callback(pi,
+        __system_property_read_callback(screenPropInfo,
             [](void* cookie, const char*, const char* value, unsigned) {
                 if (value[0])
                     strncpy((char*)cookie, value, PROP_VALUE_MAX);
@@ -309,6 +333,37 @@ public:
         return freqMap;
     }
 
+    // 最大频率最低的一组核心即能效集群, 不要求核心编号连续
+    string getLittleCoreList() {
+        const int coreTotal = sysconf(_SC_NPROCESSORS_CONF);
+        vector<int> freqList(coreTotal);
+        char path[64];
+        for (int coreIdx = 0; coreIdx < coreTotal; coreIdx++) {
+            FastSnprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", coreIdx);
+            freqList[coreIdx] = Utils::readInt(path);
+        }
+
+        int minFreq = INT32_MAX, maxFreq = 0;
+        for (const int freq : freqList) {
+            if (freq <= 0) continue;
+            minFreq = min(minFreq, freq);
+            maxFreq = max(maxFreq, freq);
+        }
+        if (maxFreq == 0 || minFreq == maxFreq) return "";
+
+        stackString<128> res;
+        for (int coreIdx = 0; coreIdx < coreTotal; coreIdx++) {
+            if (freqList[coreIdx] != minFreq) continue;
+            int endIdx = coreIdx;
+            while (endIdx + 1 < coreTotal && freqList[endIdx + 1] == minFreq) endIdx++;
+            if (res.length) res.append(',');
+            res.append(coreIdx);
+            if (endIdx > coreIdx) res.append('-').append(endIdx);
+            coreIdx = endIdx;
+        }
+        return res.c_str();
+    }
+
 
     int readBatteryWatt() {
         int voltage = Utils::readInt("/sys/class/power_supply/battery/voltage_now");
@@ -445,6 +500,8 @@ public:
         else {
             freezeit.logFmt("核心频率获取失败 cpuCluster %d size %d", cpuCluster, res.size());
         }
+
+        littleCoreList = getLittleCoreList();
     }
 
     uint32_t drawChart(uint32_t* imgBuf, uint32_t height, uint32_t width) {
@@ -703,6 +760,105 @@ public:
     }
 
 
+    // 原生断网: 通过 NETLINK_SOCK_DIAG 枚举该UID的TCP连接, 再批量 SOCK_DESTROY
+    // 返回关闭的连接数, foundCnt 为找到的连接数, 内核不支持等错误返回 -1
+    int destroySocketsByUid(const int uid, int& foundCnt) {
+        START_TIME_COUNT;
+
+        foundCnt = 0;
+        const int fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_SOCK_DIAG);
+        if (fd < 0) {
+            freezeit.logFmt("%s() 创建 sock_diag 失败 [%d]:[%s]", __FUNCTION__, errno, strerror(errno));
+            return -1;
+        }
+
+        struct diagRequest {
+            nlmsghdr nlh;
+            inet_diag_req_v2 req;
+        };
+
+        // 不处理监听及已关闭的连接
+        constexpr uint32_t states = 0xfff & ~((1 << TCP_LISTEN) | (1 << TCP_CLOSE) | (1 << TCP_TIME_WAIT));
+
+        vector<diagRequest> destroyList;
+        char buff[32 * 1024];
+
+        for (const uint8_t family : { (uint8_t)AF_INET, (uint8_t)AF_INET6 }) {
+            diagRequest dumpReq{};
+            dumpReq.nlh.nlmsg_len = sizeof(dumpReq);
+            dumpReq.nlh.nlmsg_type = SOCK_DIAG_BY_FAMILY;
+            dumpReq.nlh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+            dumpReq.req.sdiag_family = family;
+            dumpReq.req.sdiag_protocol = IPPROTO_TCP;
+            dumpReq.req.idiag_states = states;
+
+            if (send(fd, &dumpReq, sizeof(dumpReq), 0) < 0) continue;
+
+            bool isDone = false;
+            while (!isDone) {
+                int len = recv(fd, buff, sizeof(buff), 0);
+                if (len <= 0) break;
+
+                for (auto nlh = (nlmsghdr*)buff; NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len)) {
+                    if (nlh->nlmsg_type == NLMSG_DONE || nlh->nlmsg_type == NLMSG_ERROR) {
+                        isDone = true;
+                        break;
+                    }
+
+                    const auto msg = (inet_diag_msg*)NLMSG_DATA(nlh);
+                    if (msg->idiag_uid != (uint32_t)uid) continue;
+
+                    diagRequest& destroyReq = destroyList.emplace_back();
+                    memset(&destroyReq, 0, sizeof(destroyReq));
+                    destroyReq.nlh.nlmsg_len = sizeof(destroyReq);
+                    destroyReq.nlh.nlmsg_type = SOCK_DESTROY;
+                    destroyReq.nlh.nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK;
+                    destroyReq.nlh.nlmsg_seq = destroyList.size();
+                    destroyReq.req.sdiag_family = msg->idiag_family;
+                    destroyReq.req.sdiag_protocol = IPPROTO_TCP;
+                    destroyReq.req.idiag_states = 1 << msg->idiag_state;
+                    destroyReq.req.id = msg->id;
+                }
+            }
+        }
+
+        foundCnt = destroyList.size();
+        if (destroyList.empty()) {
+            close(fd);
+            END_TIME_COUNT;
+            return 0;
+        }
+
+        // 全部销毁请求合并在一次发送中, 内核逐条处理并逐条应答
+        if (send(fd, destroyList.data(), destroyList.size() * sizeof(diagRequest), 0) < 0) {
+            freezeit.logFmt("%s() SOCK_DESTROY 发送失败 [%d]:[%s]", __FUNCTION__, errno, strerror(errno));
+            close(fd);
+            return -1;
+        }
+
+        int closedCnt = 0, ackCnt = 0, lastErr = 0;
+        while (ackCnt < foundCnt) {
+            int len = recv(fd, buff, sizeof(buff), 0);
+            if (len <= 0) break;
+
+            for (auto nlh = (nlmsghdr*)buff; NLMSG_OK(nlh, len); nlh = NLMSG_NEXT(nlh, len)) {
+                if (nlh->nlmsg_type != NLMSG_ERROR) continue;
+                ackCnt++;
+                const int err = ((nlmsgerr*)NLMSG_DATA(nlh))->error;
+                if (err == 0 || err == -ENOENT) closedCnt++; // ENOENT: 连接已自行关闭
+                else lastErr = -err;
+            }
+        }
+        close(fd);
+
+        END_TIME_COUNT;
+        if (closedCnt == 0 && lastErr == EOPNOTSUPP) {
+            freezeit.log("内核不支持 SOCK_DESTROY (CONFIG_INET_DIAG_DESTROY)");
+            return -1;
+        }
+        return closedCnt;
+    }
+
     // 0获取失败 1失败 2成功
     int breakNetworkByLocalSocket(const int uid) {
         START_TIME_COUNT;
@@ -732,26 +888,172 @@ public:
 
 
 
+    // 屏幕状态属性变化时才唤醒, 开机至今未曾息屏时该属性可能尚不存在
+    void screenThreadFunc() {
+        while (getScreenProperty() < 0)
+            sleep(5);
+
+        uint32_t serial = __system_property_serial(screenPropInfo);
+        screenState = getScreenProperty();
+        freezeit.log("监听屏幕状态成功");
+
+        while (true) {
+            uint32_t newSerial;
+            if (!__system_property_wait(screenPropInfo, serial, &newSerial, nullptr))
+                continue;
+            serial = newSerial;
+            {
+                lock_guard<mutex> lock(screenMutex);
+                screenState = getScreenProperty();
+            }
+            screenCv.notify_all();
+        }
+    }
+
+    bool isScreenOff() const { return screenState == 1; }
+
+    // 息屏时阻塞等待亮屏, 状态未知时不等待
+    void waitScreenOn() {
+        std::unique_lock<mutex> lock(screenMutex);
+        screenCv.wait(lock, [this] { return screenState != 1; });
+    }
+
+    void updateChargeState() {
+        // "Unknown", "Charging", "Discharging", "Not charging", "Full"
+        // https://cs.android.com/android/kernel/superproject/+/common-android-mainline-kleaf:common/drivers/power/supply/power_supply_sysfs.c;l=75
+        char res[64];
+        Utils::readString("/sys/class/power_supply/battery/status", res, sizeof(res) - 1);
+        if (!strncmp(res, "Charging", 4) || !strncmp(res, "Full", 4))
+            chargeState = 1;
+        else if (!strncmp(res, "Discharging", 4) || !strncmp(res, "Not charging", 4))
+            chargeState = 0;
+        else
+            chargeState = -1;
+    }
+
+    // 监听内核 power_supply 的 uevent, 充电状态变化时才读取 battery/status
+    void powerThreadFunc() {
+        updateChargeState();
+
+        const int fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT);
+        if (fd < 0) {
+            freezeit.logFmt("监听充电状态失败 [%d]:[%s]", errno, strerror(errno));
+            chargeState = -1; // 改由调用方自行读取
+            return;
+        }
+
+        sockaddr_nl addr{};
+        addr.nl_family = AF_NETLINK;
+        addr.nl_groups = 1; // 内核 uevent
+        if (bind(fd, (sockaddr*)&addr, sizeof(addr))) {
+            freezeit.logFmt("监听充电状态失败 [%d]:[%s]", errno, strerror(errno));
+            close(fd);
+            chargeState = -1;
+            return;
+        }
+
+        char buff[4096];
+        while (true) {
+            const ssize_t len = recv(fd, buff, sizeof(buff) - 1, 0);
+            if (len <= 0) {
+                if (len < 0 && errno == EINTR) continue;
+                break;
+            }
+            buff[len] = 0;
+
+            // "change@/devices/.../power_supply/battery\0ACTION=change\0SUBSYSTEM=power_supply\0..."
+            if (memmem(buff, len, "SUBSYSTEM=power_supply", 22))
+                updateChargeState();
+        }
+        close(fd);
+        chargeState = -1;
+        freezeit.log("已退出监听充电状态");
+    }
+
+    // 解析正在播放的应用: 已打开的 ALSA 子流的 owner_pid 若为应用进程则直接采用,
+    // 只有 owner 为音频HAL等系统进程时, 才从 dumpsys audio 的 players 中取 state:started 的 u/pid
+    // 返回是否有系统进程持有的子流: 混音流上应用开始/停止播放不会产生新的 /dev/snd 事件, 需定时重新解析
+    bool updateAudioUids() {
+        unordered_set<int> uids;
+        bool hasSystemOwner = false;
+
+        DIR* asoundDir = opendir("/proc/asound");
+        if (asoundDir) {
+            struct dirent* card;
+            while ((card = readdir(asoundDir)) != nullptr) {
+                if (strncmp(card->d_name, "card", 4) || !isdigit(card->d_name[4])) continue;
+
+                char cardPath[64];
+                FastSnprintf(cardPath, sizeof(cardPath), "/proc/asound/%s", card->d_name);
+                DIR* cardDir = opendir(cardPath);
+                if (cardDir == nullptr) continue;
+
+                struct dirent* pcm;
+                while ((pcm = readdir(cardDir)) != nullptr) {
+                    if (strncmp(pcm->d_name, "pcm", 3) || Utils::lastChar(pcm->d_name + 4) != 'p') continue;
+
+                    for (int sub = 0; sub < 8; sub++) {
+                        char path[128], buff[512];
+                        FastSnprintf(path, sizeof(path), "%s/%s/sub%d/status", cardPath, pcm->d_name, sub);
+                        if (Utils::readString(path, buff, sizeof(buff) - 1) == 0) break;
+
+                        // 未打开的子流内容为 "closed"
+                        if (!strncmp(buff, "closed", 6)) continue;
+
+                        const char* ptr = strstr(buff, "owner_pid");
+                        if (ptr == nullptr || (ptr = strchr(ptr, ':')) == nullptr) continue;
+                        const int ownerPid = atoi(ptr + 1);
+
+                        FastSnprintf(path, sizeof(path), "/proc/%d", ownerPid);
+                        struct stat statBuf;
+                        if (ownerPid <= 0 || stat(path, &statBuf)) continue;
+                        if (statBuf.st_uid >= 10000) uids.insert(statBuf.st_uid);
+                        else hasSystemOwner = true;
+                    }
+                }
+                closedir(cardDir);
+            }
+            closedir(asoundDir);
+        }
+
+        if (hasSystemOwner) {
+            // "AudioPlaybackConfiguration piid:31 ... u/pid:10143/12345 state:started attr:..."
+            const char* cmdList[] = { "/system/bin/dumpsys", "dumpsys", "audio", nullptr };
+            VPOPEN::vpopen(cmdList[0], cmdList + 1, audioDumpBuff.get(), AUDIO_DUMP_BUF_SIZE);
+
+            const char* line = audioDumpBuff.get();
+            while (line && *line) {
+                const char* lineEnd = strchr(line, '\n');
+                const char* ptr = strstr(line, "u/pid:");
+                if (ptr && (lineEnd == nullptr || ptr < lineEnd)) {
+                    const char* statePtr = strstr(ptr, "state:started");
+                    if (statePtr && (lineEnd == nullptr || statePtr < lineEnd)) {
+                        const int uid = atoi(ptr + 6);
+                        if (uid >= 10000) uids.insert(uid);
+                    }
+                }
+                line = lineEnd ? lineEnd + 1 : nullptr;
+            }
+        }
+
+        lock_guard<mutex> lock(audioUidMutex);
+        if (uids != audioUids) {
+            audioUids = std::move(uids);
+            audioUidVersion++;
+        }
+        return hasSystemOwner;
+    }
+
+    unordered_set<int> getAudioUids() {
+        lock_guard<mutex> lock(audioUidMutex);
+        return audioUids;
+    }
+
     // https://blog.csdn.net/meccaendless/article/details/80238997
     void sndThreadFunc() {
         constexpr int SND_BUF_SIZE = 8192;
         constexpr const char* sndPath = "/dev/snd";
-
-        // const char *event_str[EVENT_NUM] =
-        // {
-        //     "IN_ACCESS",
-        //     "IN_MODIFY",
-        //     "IN_ATTRIB",
-        //     "IN_CLOSE_WRITE",
-        //     "IN_CLOSE_NOWRITE",
-        //     "IN_OPEN",
-        //     "IN_MOVED_FROM",
-        //     "IN_MOVED_TO",
-        //     "IN_CREATE",
-        //     "IN_DELETE",
-        //     "IN_DELETE_SELF",
-        //     "IN_MOVE_SELF"
-        // };
+        constexpr int SYSTEM_OWNER_REFRESH_MS = 5000;
 
         sleep(2);
 
@@ -773,9 +1075,23 @@ public:
         freezeit.log("监听音频播放事件成功");
 
         int playbackDevicesCnt = 0;
-        ssize_t readLen;
+        bool hasSystemOwner = false;
+        struct pollfd pfd = { inotifyFd, POLLIN, 0 };
+
+        while (true) {
+            // 系统进程持有的子流打开期间 定时重新解析, 否则阻塞等待 /dev/snd 事件
+            const int ret = poll(&pfd, 1, hasSystemOwner ? SYSTEM_OWNER_REFRESH_MS : -1);
+            if (ret < 0 && errno == EINTR) continue;
+            if (ret < 0) break;
+            if (ret == 0) {
+                hasSystemOwner = updateAudioUids();
+                continue;
+            }
+
+            const ssize_t readLen = read(inotifyFd, buf, SND_BUF_SIZE);
+            if (readLen < 0 && errno == EINTR) continue;
+            if (readLen <= 0) break;
 
-        while ((readLen = read(inotifyFd, buf, SND_BUF_SIZE)) > 0) {
             int readCnt{ 0 };
             while (readCnt < readLen) {
                 inotify_event* event{ reinterpret_cast<inotify_event*>(buf + readCnt) };
@@ -792,8 +1108,9 @@ public:
                         playbackDevicesCnt--;
                 }
             }
+
             isAudioPlaying = playbackDevicesCnt > 0;
-            usleep(500 * 1000);
+            hasSystemOwner = updateAudioUids();
         }
 
         inotify_rm_watch(inotifyFd, watch_d);
@@ -10,6 +10,7 @@
 #include <memory>
 #include <atomic>
 #include <mutex>
+#include <condition_variable>
 #include <limits>
 #include <set>
 #include <unordered_map>
@@ -72,6 +73,9 @@ using std::mutex;
 
 using std::make_unique;
 using std::to_string;
+using std::pair;
+using std::max;
+using std::min;
 
 
 // 配置编译选项 *****************
@@ -118,10 +122,21 @@ enum class FREEZE_MODE : uint32_t {
     SIGNAL_BREAK = 21,
     FREEZER = 30,
     FREEZER_BREAK = 31,
+    THROTTLE_CPU = 35, // 不冻结, 后台时限制CPU/IO配额
+    LITTLE_CORE = 36,  // 不冻结, 后台时只在小核运行
+    MEMORY_LIMIT = 37, // 不冻结, 后台时设置内存软上限
     WHITELIST = 40,
+    SCREENOFF = 45,   // 亮屏自由后台, 息屏后冻结
     WHITEFORCE = 50,
 };
 
+// 内存回收类型 与 /proc/pid/reclaim 的 1:file 2:anon 3:all 对应
+enum class RECLAIM_TYPE : uint8_t {
+    FILE_BACKED = 1,
+    ANON = 2,
+    ALL = 3,
+};
+
 // 1359322925 是 "Freezeit" 的10进制CRC32值
 constexpr int baseCode = 1668424211;
 
@@ -151,6 +166,14 @@ enum class STANDBY : uint32_t {
 };
 
 
+// 息屏待机阶段 按息屏时长逐级推进
+enum class STANDBY_TIER : int {
+    FREEZE = 0,         // 进入待机, 冻结前台应用
+    RECLAIM = 1,        // 回收冻结应用内存
+    TERMINATE = 2,      // 杀死价值最低的冻结应用
+    HOLD_WAKEUP = 3,    // 暂停定时解冻
+};
+
 enum class MANAGER_CMD : uint32_t {
     // 获取信息 无附加数据 No additional data required
     getPropInfo = 2,     // return string: "ID\nName\nVersion\nVersionCode\nAuthor\nclusterNum"
@@ -160,6 +183,7 @@ enum class MANAGER_CMD : uint32_t {
     getSettings = 8,     // return bytes[256]: all settings parameter
     getUidTime = 9,      // return "uid last_user_time last_sys_time user_time sys_time\n..."
     getXpLog = 10,
+    getBinderStats = 11, // return int[n*5]: [uid sample_cnt sync_recv async_recv txns_pending] 冻结期间Binder统计, 按 sync_recv+async_recv 降序
 
     // 设置 需附加数据
     setAppCfg = 21,      // send "package x\npackage x\npackage x\n..."
@@ -203,16 +227,22 @@ struct uidTimeStruct {
 
 struct appInfoStruct {
     int uid = -1;
-    FREEZE_MODE freezeMode = FREEZE_MODE::FREEZER; // [10]:杀死 [20]:SIGSTOP [30]:freezer [40]:配置 [50]:内置
+    FREEZE_MODE freezeMode = FREEZE_MODE::FREEZER; // [10]:杀死 [20]:SIGSTOP [30]:freezer [35]:限制 [40]:配置 [50]:内置
     bool isPermissive = true;      // 宽容的 有前台服务也算前台
     bool isFreeze = false;         // 冻结的 
     bool isAudioPlaying = false;   // 正在播放音频的应用
+    bool isRestricted = false;     // 限制模式: 后台限制已生效
     int delayCnt = 0;              // Binder冻结失败而延迟次数
-    int timelineUnfrozenIdx = -1;  // 解冻时间线索引
+    int timelineUnfrozenIdx = -1;  // 解冻时间线索引 (所在批次的时刻)
     bool isSystemApp = true;       // 是否系统应用
     time_t startTimestamp = 0;     // 某次开始运行时刻
     time_t stopTimestamp = 0;      // 某次冻结运行时刻
     time_t totalRunningTime = 0;   // 运行时长
+    int wakeupInterval = 0;        // 自适应定时解冻间隔(秒) 0:使用全局设置
+    static constexpr int DWELL_BUCKET_CNT = 7;
+    uint16_t dwellHist[DWELL_BUCKET_CNT] = {}; // 切到后台后多久回到前台的分布 [<5s <15s <30s <1m <2m <5m ≥5m]
+    int freezeDelay = 0;           // 自适应冻结延迟(秒) 0:使用全局设置
+    RECLAIM_TYPE reclaimType = RECLAIM_TYPE::FILE_BACKED; // 冻结时回收的内存类型
     string package;                // 包名
     string label;                  // 名称
     vector<int> pids;              // PID列表
@@ -227,7 +257,7 @@ struct appInfoStruct {
         return freezeMode == FREEZE_MODE::FREEZER_BREAK || freezeMode == FREEZE_MODE::FREEZER;
     }
     bool isSignalOrFreezer() const {
-        return freezeMode <= FREEZE_MODE::SIGNAL && freezeMode < FREEZE_MODE::WHITELIST;
+        return FREEZE_MODE::SIGNAL <= freezeMode && freezeMode <= FREEZE_MODE::FREEZER_BREAK;
     }
     bool isWhitelist() const {
         return freezeMode >= FREEZE_MODE::WHITELIST;
@@ -238,6 +268,12 @@ struct appInfoStruct {
     bool isTerminateMode() const {
         return freezeMode == FREEZE_MODE::TERMINATE;
     }
+    bool isScreenOffMode() const {
+        return freezeMode == FREEZE_MODE::SCREENOFF;
+    }
+    bool isRestrictMode() const {
+        return FREEZE_MODE::THROTTLE_CPU <= freezeMode && freezeMode < FREEZE_MODE::WHITELIST;
+    }
 };
 
 struct cfgStruct {
@@ -399,10 +435,6 @@ namespace Utils {
             if (flagBit & (1 << EV_ABS)) res.emplace_back(i);
             close(fd);
         }
-        if (res.size() == 0) {
-            fprintf(stderr, "前台任务同步事件获取失败");
-            exit(-1);
-        }
         return res;
     }
 
@@ -453,6 +485,70 @@ namespace Utils {
         return string(buff);
     }
 
+    // 按行扫描文件, 不复制行内容, 回调参数为行首指针及长度(不含'\n'), 回调返回 false 则停止
+    template <typename Callback>
+    void scanLines(const char* path, Callback&& callback) {
+        const int fd = open(path, O_RDONLY);
+        if (fd < 0) return;
+
+        char buff[16 * 1024];
+        size_t remainLen = 0;
+        ssize_t readLen;
+        while ((readLen = read(fd, buff + remainLen, sizeof(buff) - remainLen)) > 0) {
+            const size_t len = remainLen + readLen;
+            const char* lineStart = buff;
+            const char* const end = buff + len;
+            const char* lineEnd;
+            while ((lineEnd = (const char*)memchr(lineStart, '\n', end - lineStart)) != nullptr) {
+                if (!callback(lineStart, (size_t)(lineEnd - lineStart))) {
+                    close(fd);
+                    return;
+                }
+                lineStart = lineEnd + 1;
+            }
+
+            // 不完整的行留到下次读取, 超长行丢弃
+            remainLen = end - lineStart;
+            if (remainLen == sizeof(buff)) remainLen = 0;
+            memmove(buff, lineStart, remainLen);
+        }
+        if (remainLen) callback(buff, remainLen);
+        close(fd);
+    }
+
+    // 跳过 n 个以空白分隔的字段, 返回第 n 个字段的起始位置
+    const char* skipFields(const char* ptr, const char* end, int n) {
+        while (ptr < end && *ptr == ' ') ptr++;
+        while (n-- > 0 && ptr < end) {
+            while (ptr < end && *ptr != ' ') ptr++;
+            while (ptr < end && *ptr == ' ') ptr++;
+        }
+        return ptr;
+    }
+
+    // 进程累计CPU时间(utime + stime) 单位毫秒, 进程不存在则返回 -1
+    int getProcCpuTimeMs(const int pid) {
+        char path[32];
+        FastSnprintf(path, sizeof(path), "/proc/%d/stat", pid);
+
+        char buff[512];
+        if (readString(path, buff, sizeof(buff) - 1) == 0) return -1;
+
+        // 进程名可能含空格, 从最后一个')'之后开始解析, 跳过 state ~ cmajflt 共11项
+        const char* ptr = strrchr(buff, ')');
+        if (ptr == nullptr) return -1;
+        for (int i = 0; i < 12 && ptr; i++)
+            ptr = strchr(ptr + 1, ' ');
+        if (ptr == nullptr) return -1;
+
+        char* endPtr;
+        const long utime = strtol(ptr + 1, &endPtr, 10);
+        const long stime = strtol(endPtr + 1, nullptr, 10);
+
+        static const long clkTck = sysconf(_SC_CLK_TCK);
+        return static_cast<int>((utime + stime) * 1000 / (clkTck > 0 ? clkTck : 100));
+    }
+
     bool writeInt(const char* path, const int value) {
         auto fd = open(path, O_WRONLY);
         if (fd <= 0) return false;